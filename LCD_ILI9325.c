@@ -1,78 +1,167 @@
 #include "LCD_ILI9325.h"
 #include "Open1768_LCD.h"
+#include <cmsis_os2.h>
 
 void delay_ms(uint16_t ms)
 {
-   uint16_t i,j;
-   for( i = 0; i < ms; i++ )
+   uint32_t cyclesPerMs = SystemCoreClock / 1000;
+   for( uint16_t i = 0; i < ms; i++ )
    {
-      for( j = 0; j < 1141; j++ );
+      lcdDelayCycles(cyclesPerMs);
    }
 }
 
-void init_ILI9325(void) {
-   //Run only if DeviceCode is 0x9325 or 0x9328
-
-   lcdWriteReg(0xE5, 0x78F0); /* set SRAM internal timing */
-   lcdWriteReg(0x01, 0x0100); /* set Driver Output Control */
-   lcdWriteReg(0x02, 0x0700); /* set 1 line inversion */
-   lcdWriteReg(0x03, 0x1030); /* set GRAM write direction and BGR=1 */
-   lcdWriteReg(0x04, 0x0000); /* Resize register */
-   lcdWriteReg(0x08, 0x0207); /* set the back porch and front porch */
-   lcdWriteReg(0x09, 0x0000); /* set non-display area refresh cycle ISC[3:0] */
-   lcdWriteReg(0x0A, 0x0000); /* FMARK function */
-   lcdWriteReg(0x0C, 0x0000); /* RGB interface setting */
-   lcdWriteReg(0x0D, 0x0000); /* Frame marker Position */
-   lcdWriteReg(0x0F, 0x0000); /* RGB interface polarity */
+static const struct LcdInitStep ILI9325_INIT_SCRIPT[] = {
+   {0xE5, 0x78F0,   0}, /* set SRAM internal timing */
+   {0x01, 0x0100,   0}, /* set Driver Output Control */
+   {0x02, 0x0700,   0}, /* set 1 line inversion */
+   {0x03, LCD_ENTRY_MODE,   0}, /* set GRAM write direction and BGR=1 */
+   {0x04, 0x0000,   0}, /* Resize register */
+   {0x08, 0x0207,   0}, /* set the back porch and front porch */
+   {0x09, 0x0000,   0}, /* set non-display area refresh cycle ISC[3:0] */
+   {0x0A, 0x0000,   0}, /* FMARK function */
+   {0x0C, 0x0000,   0}, /* RGB interface setting */
+   {0x0D, 0x0000,   0}, /* Frame marker Position */
+   {0x0F, 0x0000,   0}, /* RGB interface polarity */
    /*************Power On sequence ****************/
-   lcdWriteReg(0x10, 0x0000); /* SAP, BT[3:0], AP, DSTB, SLP, STB */
-   lcdWriteReg(0x11, 0x0007); /* DC1[2:0], DC0[2:0], VC[2:0] */
-   lcdWriteReg(0x12, 0x0000); /* VREG1OUT voltage */
-   lcdWriteReg(0x13, 0x0000); /* VDV[4:0] for VCOM amplitude */
-   lcdWriteReg(0x07, 0x0001);
-   delay_ms(200);
+   {0x10, 0x0000,   0}, /* SAP, BT[3:0], AP, DSTB, SLP, STB */
+   {0x11, 0x0007,   0}, /* DC1[2:0], DC0[2:0], VC[2:0] */
+   {0x12, 0x0000,   0}, /* VREG1OUT voltage */
+   {0x13, 0x0000,   0}, /* VDV[4:0] for VCOM amplitude */
+   {0x07, 0x0001, 200},
    /* Dis-charge capacitor power voltage */
-   lcdWriteReg(0x10, 0x1090); /* SAP, BT[3:0], AP, DSTB, SLP, STB */
-   lcdWriteReg(0x11, 0x0227); /* Set DC1[2:0], DC0[2:0], VC[2:0] */
-   delay_ms(50);                      /* Delay 50ms */
-   lcdWriteReg(0x12, 0x001F);
-   delay_ms(50);                      /* Delay 50ms */
-   lcdWriteReg(0x13, 0x1500); /* VDV[4:0] for VCOM amplitude */
-   lcdWriteReg(0x29, 0x0027); /* 04 VCM[5:0] for VCOMH */
-   lcdWriteReg(0x2B, 0x000D); /* Set Frame Rate */
-   delay_ms(50);                      /* Delay 50ms */
-   lcdWriteReg(0x20, 0x0000); /* GRAM horizontal Address */
-   lcdWriteReg(0x21, 0x0000); /* GRAM Vertical Address */
+   {0x10, 0x1090,   0}, /* SAP, BT[3:0], AP, DSTB, SLP, STB */
+   {0x11, 0x0227,  50}, /* Set DC1[2:0], DC0[2:0], VC[2:0] */
+   {0x12, 0x001F,  50},
+   {0x13, 0x1500,   0}, /* VDV[4:0] for VCOM amplitude */
+   {0x29, 0x0027,   0}, /* 04 VCM[5:0] for VCOMH */
+   {0x2B, 0x000D,  50}, /* Set Frame Rate */
+   {0x20, 0x0000,   0}, /* GRAM horizontal Address */
+   {0x21, 0x0000,   0}, /* GRAM Vertical Address */
    /* ----------- Adjust the Gamma Curve ---------- */
-   lcdWriteReg(0x30, 0x0000);
-   lcdWriteReg(0x31, 0x0707);
-   lcdWriteReg(0x32, 0x0307);
-   lcdWriteReg(0x35, 0x0200);
-   lcdWriteReg(0x36, 0x0008);
-   lcdWriteReg(0x37, 0x0004);
-   lcdWriteReg(0x38, 0x0000);
-   lcdWriteReg(0x39, 0x0707);
-   lcdWriteReg(0x3C, 0x0002);
-   lcdWriteReg(0x3D, 0x1D04);
+   {0x30, 0x0000,   0},
+   {0x31, 0x0707,   0},
+   {0x32, 0x0307,   0},
+   {0x35, 0x0200,   0},
+   {0x36, 0x0008,   0},
+   {0x37, 0x0004,   0},
+   {0x38, 0x0000,   0},
+   {0x39, 0x0707,   0},
+   {0x3C, 0x0002,   0},
+   {0x3D, 0x1D04,   0},
    /* ------------------ Set GRAM area --------------- */
-   lcdWriteReg(0x50, 0x0000); /* Horizontal GRAM Start Address */
-   lcdWriteReg(0x51, 0x00EF); /* Horizontal GRAM End Address */
-   lcdWriteReg(0x52, 0x0000); /* Vertical GRAM Start Address */
-   lcdWriteReg(0x53, 0x013F); /* Vertical GRAM Start Address */
-   lcdWriteReg(0x60, 0xA700); /* Gate Scan Line */
-   lcdWriteReg(0x61, 0x0001); /* NDL,VLE, REV */
-   lcdWriteReg(0x6A, 0x0000); /* set scrolling line */
+   {0x50, 0x0000,   0}, /* Horizontal GRAM Start Address */
+   {0x51, 0x00EF,   0}, /* Horizontal GRAM End Address */
+   {0x52, 0x0000,   0}, /* Vertical GRAM Start Address */
+   {0x53, 0x013F,   0}, /* Vertical GRAM Start Address */
+   {0x60, 0xA700,   0}, /* Gate Scan Line */
+   {0x61, 0x0001,   0}, /* NDL,VLE, REV */
+   {0x6A, 0x0000,   0}, /* set scrolling line */
    /* -------------- Partial Display Control --------- */
-   lcdWriteReg(0x80, 0x0000);
-   lcdWriteReg(0x81, 0x0000);
-   lcdWriteReg(0x82, 0x0000);
-   lcdWriteReg(0x83, 0x0000);
-   lcdWriteReg(0x84, 0x0000);
-   lcdWriteReg(0x85, 0x0000);
+   {0x80, 0x0000,   0},
+   {0x81, 0x0000,   0},
+   {0x82, 0x0000,   0},
+   {0x83, 0x0000,   0},
+   {0x84, 0x0000,   0},
+   {0x85, 0x0000,   0},
    /* -------------- Panel Control ------------------- */
-   lcdWriteReg(0x90, 0x0010);
-   lcdWriteReg(0x92, 0x0600);
-   lcdWriteReg(0x07, 0x0133); /* 262K color and display ON */
+   {0x90, 0x0010,   0},
+   {0x92, 0x0600,   0},
+   {0x07, 0x0133,  50}, /* 262K color and display ON */
+};
+
+const struct LcdInitSequence ILI9325_INIT_SEQUENCE = {
+   ILI9325_INIT_SCRIPT,
+   sizeof(ILI9325_INIT_SCRIPT) / sizeof(ILI9325_INIT_SCRIPT[0])
+};
+
+int lcdInitStep(const struct LcdInitSequence* sequence, uint16_t* nextStep)
+{
+   while(*nextStep < sequence->length)
+   {
+      const struct LcdInitStep* step = &sequence->steps[*nextStep];
+      lcdWriteReg(step->reg, step->value);
+      *nextStep += 1;
+      if(step->delayMs != 0)
+      {
+         return step->delayMs;
+      }
+   }
+   return LCD_INIT_DONE;
+}
 
-   delay_ms(50);
+void lcdInitDelay(uint16_t ms)
+{
+   if(osKernelGetState() == osKernelRunning)
+   {
+      osDelay((ms * osKernelGetTickFreq() + 999) / 1000);
+   }
+   else
+   {
+      delay_ms(ms);
+   }
+}
+
+void lcdRunInitSequence(const struct LcdInitSequence* sequence)
+{
+   uint16_t nextStep = 0;
+   int delayMs;
+   while((delayMs = lcdInitStep(sequence, &nextStep)) != LCD_INIT_DONE)
+   {
+      lcdInitDelay(delayMs);
+   }
+}
+
+static enum lcd_power_mode lcdPowerMode = LCD_POWER_FULL;
+
+void init_ILI9325(void) {
+   //Run only if DeviceCode is 0x9325 or 0x9328
+   lcdRunInitSequence(&ILI9325_INIT_SEQUENCE);
+   lcdPowerMode = LCD_POWER_FULL;
+}
+
+static const struct LcdInitStep ILI9325_STANDBY_ENTER_SCRIPT[] = {
+   {0x07, 0x0131,  10}, /* gate output VGL, 2 frames */
+   {0x07, 0x0130,  10},
+   {0x07, 0x0000,   0}, /* display OFF */
+   {0x10, 0x1091,   0}, /* power settings of init kept, STB=1 */
+};
+
+static const struct LcdInitStep ILI9325_STANDBY_EXIT_SCRIPT[] = {
+   {0x10, 0x1090,  10}, /* STB=0, oscillator start, R07h follows with the new mode */
+};
+
+static const struct LcdInitSequence ILI9325_STANDBY_ENTER_SEQUENCE = {
+   ILI9325_STANDBY_ENTER_SCRIPT,
+   sizeof(ILI9325_STANDBY_ENTER_SCRIPT) / sizeof(ILI9325_STANDBY_ENTER_SCRIPT[0])
+};
+
+static const struct LcdInitSequence ILI9325_STANDBY_EXIT_SEQUENCE = {
+   ILI9325_STANDBY_EXIT_SCRIPT,
+   sizeof(ILI9325_STANDBY_EXIT_SCRIPT) / sizeof(ILI9325_STANDBY_EXIT_SCRIPT[0])
+};
+
+void lcdSetPowerMode(enum lcd_power_mode mode)
+{
+   if(mode == lcdPowerMode)
+   {
+      return;
+   }
+   if(lcdPowerMode == LCD_POWER_STANDBY)
+   {
+      lcdRunInitSequence(&ILI9325_STANDBY_EXIT_SEQUENCE);
+   }
+   switch(mode)
+   {
+      case LCD_POWER_FULL:
+         lcdWriteReg(0x07, 0x0133); /* 262K color and display ON */
+         break;
+      case LCD_POWER_8_COLOR:
+         lcdWriteReg(0x07, 0x013B); /* CL=1, 8 color and display ON */
+         break;
+      case LCD_POWER_STANDBY:
+         lcdRunInitSequence(&ILI9325_STANDBY_ENTER_SEQUENCE);
+         break;
+   }
+   lcdPowerMode = mode;
 }
@@ -18,9 +18,32 @@
 #define DATA_RAM 0x0022 //RAM data
 
 /**
- * Defines initial rotation of the screen.
+ * Defines initial rotation of the screen, may be set in project defines.
  */
-#define DISP_ORIENTATION  0  /* angle 0 90 */
+#ifndef DISP_ORIENTATION
+#define DISP_ORIENTATION  0  /* angle 0 90 180 270 */
+#endif
+
+/**
+ * GRAM size, always portrait. Rotation is done by the address
+ * update direction, so windows and bursts work in every angle.
+ */
+#define  LCD_GRAM_WIDTH   240
+#define  LCD_GRAM_HEIGHT  320
+
+/**
+ * Entry mode with BGR=1, AM (bit 3) selects vertical address update,
+ * ID0 (bit 4) and ID1 (bit 5) select horizontal and vertical increment
+ */
+#if    ( DISP_ORIENTATION == 0 )
+#define  LCD_ENTRY_MODE   0x1030
+#elif  ( DISP_ORIENTATION == 90 )
+#define  LCD_ENTRY_MODE   0x1018
+#elif  ( DISP_ORIENTATION == 180 )
+#define  LCD_ENTRY_MODE   0x1000
+#elif  ( DISP_ORIENTATION == 270 )
+#define  LCD_ENTRY_MODE   0x1028
+#endif
 
 #if  ( DISP_ORIENTATION == 90 ) || ( DISP_ORIENTATION == 270 )
 
@@ -74,10 +97,50 @@
 #ifndef __LCD_ILI9325_H
 #define __LCD_ILI9325_H
 
+#include <stdint.h>
+
+/*****************************
+ *  Controller init script
+ *  (register, value, delay after write)
+ */
+struct LcdInitStep {
+   uint16_t reg;
+   uint16_t value;
+   uint16_t delayMs;
+};
+
+struct LcdInitSequence {
+   const struct LcdInitStep* steps;
+   uint16_t length;
+};
+
+#define LCD_INIT_DONE (-1)
+
+extern const struct LcdInitSequence ILI9325_INIT_SEQUENCE;
+
+/* Writes registers from nextStep up to the next delay,
+ * returns the delay in ms or LCD_INIT_DONE */
+int lcdInitStep(const struct LcdInitSequence* sequence, uint16_t* nextStep);
+/* osDelay once the kernel runs, busy wait before */
+void lcdInitDelay(uint16_t ms);
+void lcdRunInitSequence(const struct LcdInitSequence* sequence);
+
 /*****************************
  *  LCD controler configuration
  */
 void init_ILI9325(void);
 
+enum lcd_power_mode{
+   LCD_POWER_FULL,      // 262K colors
+   LCD_POWER_8_COLOR,   // 1 bit per color, GRAM kept
+   LCD_POWER_STANDBY    // display off, GRAM kept, no GRAM access
+};
+
+/*****************************
+ *  Switches display mode, waits needed
+ *  to leave standby are done here
+ */
+void lcdSetPowerMode(enum lcd_power_mode mode);
+
 #endif
 
@@ -22,9 +22,19 @@
 #include "Open1768_LCD.h"
 #include <stdlib.h>
 #include "LCD_ILI9325.h"
+#include "lcdProfile.h"
+#include "periphPower.h"
+#include "cycleCounter.h"
 
-//Header needed because of inline function definition
-void wait_delay(int count);
+/* Bus timings converted to core clock cycles by lcdTimingInit */
+static uint32_t lcdWriteLowCycles;
+static uint32_t lcdWriteHighCycles;
+static uint32_t lcdReadAccessCycles;
+static uint32_t lcdBufferCycles;
+static uint32_t lcdHoldCycles;
+
+/* DWT->CYCCNT at the last WR rising edge, bus holds are counted from it */
+static uint32_t lcdWriteRise;
 
 /*******************************************************************************
 * Function Name  : Lcd_Configuration
@@ -43,10 +53,95 @@ void lcdConfiguration(void)
        as output.
    */
 
+   periphPowerAcquire(PERIPH_POWER_GPIO);
    LPC_GPIO0->FIODIR |= PIN_RS | PIN_RD | PIN_CS | PIN_WR;
    LPC_GPIO1->FIODIR |= PIN_LE | PIN_DIR | PIN_EN;
    LPC_GPIO0->FIOSET = PIN_RS | PIN_RD | PIN_CS | PIN_WR;
    LPC_GPIO1->FIOSET = PIN_LE | PIN_DIR | PIN_EN;
+
+   lcdTimingInit();
+}
+
+/*******************************************************************************
+* Function Name  : lcdNsToCycles
+* Description    : Converts time to core clock cycles, rounding up
+* Input          : - ns: time in nanoseconds
+*                  - coreClock: core clock in Hz
+* Output         : None
+* Return         : Number of cycles lasting at least ns
+* Attention      : None
+*******************************************************************************/
+uint32_t lcdNsToCycles(uint32_t ns, uint32_t coreClock)
+{
+   return (uint32_t)(((uint64_t)ns * coreClock + 999999999) / 1000000000);
+}
+
+/*******************************************************************************
+* Function Name  : lcdTimingInit
+* Description    : Starts DWT cycle counter and computes bus timings
+*                  for current SystemCoreClock
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : Has to be called again after core clock change
+*******************************************************************************/
+void lcdTimingInit(void)
+{
+   SystemCoreClockUpdate();
+
+   cycleCounterEnable();
+
+   lcdWriteLowCycles = lcdNsToCycles(LCD_T_WRL_NS, SystemCoreClock);
+   lcdWriteHighCycles = lcdNsToCycles(LCD_T_WRH_NS, SystemCoreClock);
+   lcdReadAccessCycles = lcdNsToCycles(LCD_T_RDL_NS, SystemCoreClock);
+   lcdBufferCycles = lcdNsToCycles(LCD_T_BUF_NS, SystemCoreClock);
+   lcdHoldCycles = lcdNsToCycles(LCD_T_DHW_NS > LCD_T_AH_NS ? LCD_T_DHW_NS : LCD_T_AH_NS, SystemCoreClock);
+}
+
+/*******************************************************************************
+* Function Name  : lcdDelayCycles
+* Description    : Busy waits on DWT cycle counter
+* Input          : - cycles: number of core clock cycles
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+void lcdDelayCycles(uint32_t cycles)
+{
+   LCD_PROFILE_START();
+   cycleCounterWaitSince(DWT->CYCCNT, cycles);
+   LCD_PROFILE_STOP(LCD_PROFILE_DELAY, 0);
+}
+
+/*******************************************************************************
+* Function Name  : lcdWaitBusHold
+* Description    : Waits for data, RS and CS hold after the last WR rise
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : Before anything on the bus changes
+*******************************************************************************/
+static inline void lcdWaitBusHold(void)
+{
+   cycleCounterWaitSince(lcdWriteRise, lcdHoldCycles);
+}
+
+/*******************************************************************************
+* Function Name  : lcdStrobeWrite
+* Description    : WR pulse, data is sampled on its rising edge
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : WR high time is counted from the previous rising edge.
+*                  Inline with inline waits, it runs once per pixel
+*******************************************************************************/
+static inline void lcdStrobeWrite(void)
+{
+   cycleCounterWaitSince(lcdWriteRise, lcdWriteHighCycles);
+   LCD_WR(0);
+   cycleCounterWaitSince(DWT->CYCCNT, lcdWriteLowCycles);
+   LCD_WR(1);
+   lcdWriteRise = DWT->CYCCNT;
 }
 
 /*******************************************************************************
@@ -62,25 +157,11 @@ void lcdSend (uint16_t byte)
    LPC_GPIO2->FIODIR |= 0xFF;        /* P2.0...P2.7 Output */
    LCD_DIR(1)                        /* Interface A->B */
    LCD_EN(0)                         /* Enable 2A->2B */
-   LPC_GPIO2->FIOPIN =  byte;        /* Write D0..D7 */
+   LPC_GPIO2->FIOPIN0 = byte;        /* Write D0..D7 */
    LCD_LE(1)
    LCD_LE(0)                         /* latch D0..D7   */
-   LPC_GPIO2->FIOPIN =  byte >> 8;   /* Write D8..D15 */
-}
-
-/*******************************************************************************
-* Function Name  : wait_delay
-* Description    : Delay Time
-* Input          : - nCount: Delay Time
-* Output         : None
-* Return         : None
-* Return         : None
-* Attention       : None
-*******************************************************************************/
-__INLINE void wait_delay(int count)
-{
-   volatile unsigned int tmp = count;
-   while(tmp--);
+   LCD_PROFILE_LATCH();
+   LPC_GPIO2->FIOPIN0 = byte >> 8;   /* Write D8..D15 */
 }
 
 /*******************************************************************************
@@ -97,10 +178,10 @@ uint16_t lcdRead (void)
    LPC_GPIO2->FIODIR &= ~(0xFF);         /* P2.0...P2.7 Input */
    LCD_DIR(0);                           /* Interface B->A */
    LCD_EN(0);                            /* Enable 2B->2A */
-   wait_delay(50);                       /* delay some times */
+   lcdDelayCycles(lcdBufferCycles);      /* buffer propagation */
    valMSB = LPC_GPIO2->FIOPIN0;          /* Read D8..D15 */
    LCD_EN(1);                            /* Enable 1B->1A */
-   wait_delay(50);                       /* delay some times */
+   lcdDelayCycles(lcdBufferCycles);      /* buffer propagation */
    //value = (value << 8) |
    valLSB = LPC_GPIO2->FIOPIN0;          /* Read D0..D7 */
    LCD_DIR(1);
@@ -115,6 +196,7 @@ uint16_t lcdRead (void)
 *******************************************************************************/
 void lcdWriteIndex(uint16_t index)
 {
+   LCD_PROFILE_START();
    /**********************************
    // ** nCS      ---\________/------*
    // ** RS       ----\______/-------*
@@ -122,15 +204,15 @@ void lcdWriteIndex(uint16_t index)
    // ** nWR      -----\___/---------*
    // ** DB[0-15] ------[###]--------*
    **********************************/
+   lcdWaitBusHold();
    LCD_CS(0);
    LCD_RS(0);
    LCD_RD(1);
    lcdSend( index );
-   wait_delay(50);
-   LCD_WR(0);
-   wait_delay(1);
-   LCD_WR(1);
+   lcdStrobeWrite();
+   lcdWaitBusHold();
    LCD_CS(1);
+   LCD_PROFILE_STOP(LCD_PROFILE_WRITE_INDEX, 1);
 }
 
 /*******************************************************************************
@@ -141,6 +223,7 @@ void lcdWriteIndex(uint16_t index)
 *******************************************************************************/
 void lcdWriteData(uint16_t data)
 {
+   LCD_PROFILE_START();
    /**********************************
    // ** nCS      ---\________/-----**
    // ** RS       ------------------**
@@ -148,12 +231,102 @@ void lcdWriteData(uint16_t data)
    // ** nWR      -----\___/--------**
    // ** DB[0-15] ------[###]-------**
    **********************************/
+   lcdWaitBusHold();
    LCD_CS(0);
    LCD_RS(1);
    lcdSend( data );
-   LCD_WR(0);
-   wait_delay(1);
-   LCD_WR(1);
+   lcdStrobeWrite();
+   lcdWaitBusHold();
+   LCD_CS(1);
+   LCD_PROFILE_STOP(LCD_PROFILE_WRITE_DATA, 1);
+}
+
+/*******************************************************************************
+* Function Name  : lcdBeginDataStream
+* Description    : Prepares the bus for a burst of lcdStreamData calls.
+*                  Bus direction, CS and RS are set once for the whole burst.
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : Index (e.g. DATA_RAM) has to be written before,
+*                  no other bus access allowed until lcdEndDataStream
+*******************************************************************************/
+void lcdBeginDataStream(void)
+{
+   lcdWaitBusHold();
+   LPC_GPIO2->FIODIR0 = 0xFF;        /* P2.0...P2.7 Output */
+   LCD_DIR(1)                        /* Interface A->B */
+   LCD_EN(0)                         /* Enable 2A->2B */
+   LCD_RD(1);
+   LCD_RS(1);
+   LCD_CS(0);
+}
+
+/*******************************************************************************
+* Function Name  : lcdStreamData
+* Description    : Writes one data word inside a burst, only latches both
+*                  bytes and strobes WR.
+* Input          : - data: word to be written
+* Output         : None
+* Return         : None
+* Attention      : Only between lcdBeginDataStream and lcdEndDataStream
+*******************************************************************************/
+void lcdStreamData(uint16_t data)
+{
+   LCD_PROFILE_START();
+   /**********************************
+   // ** nCS      \_________________**
+   // ** RS       /-----------------**
+   // ** nWR      -----\___/--------**
+   // ** DB[0-15] ------[###]-------**
+   **********************************/
+   lcdWaitBusHold();
+   LPC_GPIO2->FIOPIN0 = data;        /* Write D0..D7 */
+   LPC_GPIO1->FIOSET = PIN_LE;
+   LPC_GPIO1->FIOCLR = PIN_LE;       /* latch D0..D7   */
+   LCD_PROFILE_LATCH();
+   LPC_GPIO2->FIOPIN0 = data >> 8;   /* Write D8..D15 */
+   lcdStrobeWrite();
+   LCD_PROFILE_STOP(LCD_PROFILE_STREAM, 1);
+}
+
+/*******************************************************************************
+* Function Name  : lcdStreamFill
+* Description    : Writes the same data word count times. Bus value is
+*                  latched once, then only WR is strobed.
+* Input          : - data: word to be written
+*                  - count: number of writes
+* Output         : None
+* Return         : None
+* Attention      : Only between lcdBeginDataStream and lcdEndDataStream
+*******************************************************************************/
+void lcdStreamFill(uint16_t data, uint32_t count)
+{
+   LCD_PROFILE_START();
+   lcdWaitBusHold();
+   LPC_GPIO2->FIOPIN0 = data;        /* Write D0..D7 */
+   LPC_GPIO1->FIOSET = PIN_LE;
+   LPC_GPIO1->FIOCLR = PIN_LE;       /* latch D0..D7   */
+   LCD_PROFILE_LATCH();
+   LPC_GPIO2->FIOPIN0 = data >> 8;   /* Write D8..D15 */
+   for(uint32_t n = 0; n < count; n++)
+   {
+      lcdStrobeWrite();
+   }
+   LCD_PROFILE_STOP(LCD_PROFILE_STREAM, count);
+}
+
+/*******************************************************************************
+* Function Name  : lcdEndDataStream
+* Description    : Finishes burst started with lcdBeginDataStream.
+* Input          : None
+* Output         : None
+* Return         : None
+* Attention      : None
+*******************************************************************************/
+void lcdEndDataStream(void)
+{
+   lcdWaitBusHold();
    LCD_CS(1);
 }
 
@@ -165,6 +338,7 @@ void lcdWriteData(uint16_t data)
 *******************************************************************************/
 uint16_t lcdReadData(void)
 {
+   LCD_PROFILE_START();
    /**********************************
    // ** nCS      ---\________/-----**
    // ** RS       ------------------**
@@ -174,16 +348,18 @@ uint16_t lcdReadData(void)
    **********************************/
    uint16_t value;
 
+   lcdWaitBusHold();
    LCD_CS(0);
    LCD_RS(1);
    LCD_WR(1);
    LCD_RD(0);
-   wait_delay(1);
+   lcdDelayCycles(lcdReadAccessCycles);
    value = lcdRead();
 
    LCD_RD(1);
    LCD_CS(1);
 
+   LCD_PROFILE_STOP(LCD_PROFILE_READ_DATA, 1);
    return value;
 }
 
@@ -198,10 +374,12 @@ uint16_t lcdReadData(void)
 *******************************************************************************/
 void lcdWriteReg(uint16_t LCD_Reg,uint16_t LCD_RegValue)
 {
+   LCD_PROFILE_START();
    /* Write 16-bit Index, then Write Reg */
    lcdWriteIndex(LCD_Reg);
    /* Write 16-bit Reg */
    lcdWriteData(LCD_RegValue);
+   LCD_PROFILE_STOP(LCD_PROFILE_WRITE_REG, 1);
 }
 
 /*******************************************************************************
@@ -223,6 +401,32 @@ uint16_t lcdReadReg(uint16_t LCD_Reg)
    return LCD_RAM;
 }
 
+/*******************************************************************************
+* Function Name  : lcdMapPoint
+* Description    : Maps screen coordinates of DISP_ORIENTATION to GRAM address.
+* Input          : - Xpos: specifies the X position.
+*                  - Ypos: specifies the Y position.
+* Output         : - gramX, gramY: GRAM horizontal and vertical address
+* Return         : None
+* Attention      : Matches the address update direction of LCD_ENTRY_MODE
+*******************************************************************************/
+static void lcdMapPoint(uint16_t Xpos, uint16_t Ypos, uint16_t* gramX, uint16_t* gramY)
+{
+   #if    ( DISP_ORIENTATION == 90 )
+   *gramX = Ypos;
+   *gramY = ( LCD_GRAM_HEIGHT - 1 ) - Xpos;
+   #elif  ( DISP_ORIENTATION == 180 )
+   *gramX = ( LCD_GRAM_WIDTH - 1 ) - Xpos;
+   *gramY = ( LCD_GRAM_HEIGHT - 1 ) - Ypos;
+   #elif  ( DISP_ORIENTATION == 270 )
+   *gramX = ( LCD_GRAM_WIDTH - 1 ) - Ypos;
+   *gramY = Xpos;
+   #else
+   *gramX = Xpos;
+   *gramY = Ypos;
+   #endif
+}
+
 /*******************************************************************************
 * Function Name  : LCD_SetCursor
 * Description    : Sets the cursor position.
@@ -234,20 +438,38 @@ uint16_t lcdReadReg(uint16_t LCD_Reg)
 *******************************************************************************/
 void lcdSetCursor(uint16_t Xpos, uint16_t Ypos)
 {
-    #if  ( DISP_ORIENTATION == 90 ) || ( DISP_ORIENTATION == 270 )
-
-    uint16_t temp = Xpos;
-
-   Xpos = Ypos;
-   Ypos = ( LCD_MAX_X - 1 ) - temp;
+   LCD_PROFILE_START();
+   uint16_t gramX, gramY;
 
-   #elif  ( DISP_ORIENTATION == 0 ) || ( DISP_ORIENTATION == 180 )
+   lcdMapPoint(Xpos, Ypos, &gramX, &gramY);
+   lcdWriteReg(ADRX_RAM, gramX );
+   lcdWriteReg(ADRY_RAM, gramY );
+   LCD_PROFILE_STOP(LCD_PROFILE_SET_CURSOR, 2);
+}
 
-   #endif
+/*******************************************************************************
+* Function Name  : lcdSetWindow
+* Description    : Sets GRAM window of screen rectangle and puts the cursor
+*                  in its top left corner.
+* Input          : - xStart, xEnd: inclusive columns
+*                  - yStart, yEnd: inclusive rows
+* Output         : None
+* Return         : None
+* Attention      : Following DATA_RAM writes fill the rectangle row by row
+*                  in every DISP_ORIENTATION, LCD_ENTRY_MODE has to be set
+*******************************************************************************/
+void lcdSetWindow(uint16_t xStart, uint16_t xEnd, uint16_t yStart, uint16_t yEnd)
+{
+   uint16_t startX, startY, endX, endY;
 
+   lcdMapPoint(xStart, yStart, &startX, &startY);
+   lcdMapPoint(xEnd, yEnd, &endX, &endY);
+   lcdWriteReg(HADRPOS_RAM_START, startX < endX ? startX : endX);
+   lcdWriteReg(HADRPOS_RAM_END, startX < endX ? endX : startX);
+   lcdWriteReg(VADRPOS_RAM_START, startY < endY ? startY : endY);
+   lcdWriteReg(VADRPOS_RAM_END, startY < endY ? endY : startY);
 
-   lcdWriteReg(ADRX_RAM, Xpos );
-   lcdWriteReg(ADRY_RAM, Ypos );
+   lcdSetCursor(xStart, yStart);
 }
 
 /*********************************************************************************************************
@@ -48,6 +48,21 @@
 #define LCD_RS(x)   ((x) ? (LPC_GPIO0->FIOSET = PIN_RS) : (LPC_GPIO0->FIOCLR = PIN_RS));
 
 
+/* ILI9325 i80 bus timing (datasheet AC characteristics) in ns --------------*/
+#define LCD_T_WRL_NS   50   /* WR low pulse width, covers data setup       */
+#define LCD_T_WRH_NS   50   /* WR high pulse width                         */
+#define LCD_T_RDL_NS  170   /* RD low pulse width, covers read access time */
+#define LCD_T_BUF_NS   30   /* 74HC245 propagation after direction change  */
+#define LCD_T_DSW_NS   10   /* data setup before WR rise                   */
+#define LCD_T_DHW_NS   15   /* data hold after WR rise                     */
+#define LCD_T_AH_NS     5   /* RS and CS hold after WR rise                */
+
+/* Data is on the bus before WR falls, so WR low time covers data setup */
+#if LCD_T_DSW_NS > LCD_T_WRL_NS
+#error "LCD_T_DSW_NS has to fit in LCD_T_WRL_NS"
+#endif
+
+
 /* Display define ------------------------------------------------------------*/
 #define  ILI9320    0  /* 0x9320 */
 #define  ILI9325    1  /* 0x9325 */
@@ -75,6 +90,14 @@
 void lcdConfiguration(void);
 
 
+/*****************************
+ *  Bus timing
+ */
+uint32_t lcdNsToCycles(uint32_t ns, uint32_t coreClock);
+void lcdTimingInit(void);
+void lcdDelayCycles(uint32_t cycles);
+
+
 /*****************************
  *   Low level procedures
  */
@@ -91,6 +114,16 @@ void lcdWriteData(uint16_t index);
 uint16_t lcdReadData(void);
 
 
+/*****************************
+ *   Burst data write
+ *   (bus set up once, WR strobe per word)
+ */
+void lcdBeginDataStream(void);
+void lcdStreamData(uint16_t data);
+void lcdStreamFill(uint16_t data, uint32_t count);
+void lcdEndDataStream(void);
+
+
 /*****************************
  *   High level (compound)
  *   comunication procedures
@@ -98,5 +131,6 @@ uint16_t lcdReadData(void);
 void lcdWriteReg(uint16_t LCD_Reg,uint16_t LCD_RegValue);
 uint16_t lcdReadReg(uint16_t LCD_Reg);
 void lcdSetCursor(uint16_t Xpos, uint16_t Ypos);
+void lcdSetWindow(uint16_t xStart, uint16_t xEnd, uint16_t yStart, uint16_t yEnd);
 
 #endif
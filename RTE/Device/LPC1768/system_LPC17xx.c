@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 #include "LPC17xx.h"
+#include "periphPower.h"
 
 /*
 //-------- <<< Use Configuration Wizard in Context Menu >>> ------------------
@@ -303,7 +304,7 @@
 #define USBCLKCFG_Val         0x00000000
 #define PCLKSEL0_Val          0x00000000
 #define PCLKSEL1_Val          0x00000000
-#define PCONP_Val             0x042887DE
+#define PCONP_Val             0x00000000
 #define CLKOUTCFG_Val         0x00000000
 
 
@@ -491,8 +492,7 @@ void SystemInit (void)
   /* Periphral clock must be selected before PLL0 enabling and connecting
    * - according errata.lpc1768-16.March.2010 -
    */
-  LPC_SC->PCLKSEL0  = PCLKSEL0_Val;     /* Peripheral Clock Selection         */
-  LPC_SC->PCLKSEL1  = PCLKSEL1_Val;
+  periphPowerClockSetup();              /* Peripheral Clock Selection, per block of periphPower.c */
 
   LPC_SC->CLKSRCSEL = CLKSRCSEL_Val;    /* Select Clock Source sysclk / PLL0  */
 
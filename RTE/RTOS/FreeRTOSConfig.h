@@ -104,8 +104,15 @@
 //  <i> Enable callback function call on each idle task iteration.
 //  <i> Callback function vApplicationIdleHook implementation is required when idle hook is enabled.
 //  <i> Default: 0
+//  <i> Keep off with tickless idle, the hook would sleep with the tick running before the port sleeps.
 #define configUSE_IDLE_HOOK                     0
 
+//  <q>Use tickless idle
+//  <i> Stop the periodic tick while all tasks are blocked and sleep until the next timeout or interrupt.
+//  <i> SysTick limits one sleep to 2^24 core clock cycles.
+//  <i> Default: 0
+#define configUSE_TICKLESS_IDLE                 1
+
 //  <q>Use tick hook
 //  <i> Enable callback function call during each tick interrupt.
 //  <i> Callback function vApplicationTickHook implementation is required when tick hook is enabled.
@@ -259,6 +266,12 @@
 #if (defined(__ARMCC_VERSION) || defined(__GNUC__) || defined(__ICCARM__))
 /* Include debug event definitions */
 #include "freertos_evr.h"
+
+/* Power state residency and wake latency, see lowPower.h */
+extern void lowPowerSleepEnter(void);
+extern void lowPowerSleepExit(void);
+#define configPRE_SLEEP_PROCESSING(x)           lowPowerSleepEnter()
+#define configPOST_SLEEP_PROCESSING(x)          lowPowerSleepExit()
 #endif
 
 #endif /* FREERTOS_CONFIG_H */
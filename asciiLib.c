@@ -24,7 +24,8 @@
 
 
 //#ifdef ASCII_8X16_MS_Gothic
-static unsigned char const AsciiLib[2][95][16] = {{
+/* Only compiled in fonts take flash, see ASCII_FONT_SYSTEM */
+static unsigned char const AsciiLib[ASCII_FONTS][ASCII_LAST_CHAR - ASCII_FIRST_CHAR + 1][ASCII_GLYPH_HEIGHT] = {{
 
 {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*" ",0*/
 
@@ -221,7 +222,7 @@ static unsigned char const AsciiLib[2][95][16] = {{
 //#endif
 
 
-//#ifdef ASCII_8X16_System
+#if ASCII_FONT_SYSTEM
 //static unsigned char const AsciiLib_8X16_System[95][16] =
 {
 {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*" ",0*/
@@ -413,7 +414,9 @@ static unsigned char const AsciiLib[2][95][16] = {{
 {0x00,0x00,0x00,0x30,0x18,0x18,0x18,0x0C,0x06,0x0C,0x18,0x18,0x18,0x30,0x00,0x00},/*"}",93*/
 
 {0x00,0x00,0x00,0x71,0xDB,0x8E,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00},/*"~",94*/
-}};
+}
+#endif
+};
 
 //#endif
 
@@ -428,7 +431,31 @@ static unsigned char const AsciiLib[2][95][16] = {{
 *******************************************************************************/
 void GetASCIICode(int font, unsigned char* pBuffer, unsigned char ASCII)
 {
-   memcpy(pBuffer, AsciiLib[font][(ASCII - 32)], 16);
+   memcpy(pBuffer, GetASCIIGlyph(font, ASCII), ASCII_GLYPH_HEIGHT);
+}
+
+/*******************************************************************************
+* Function Name  : GetASCIIGlyph
+* Description    : Glyph rows in flash, one byte per row, MSB is left column
+* Input          : - font: ASCII_8X16_MS_Gothic or ASCII_8X16_System
+*                  - ASCII: character code
+* Output         : None
+* Return         : Pointer to ASCII_GLYPH_HEIGHT rows
+* Attention      : Characters outside ASCII_FIRST_CHAR..ASCII_LAST_CHAR
+*                  give the ASCII_FALLBACK_CHAR glyph, fonts not compiled
+*                  in give ASCII_8X16_MS_Gothic
+*******************************************************************************/
+const unsigned char* GetASCIIGlyph(int font, unsigned char ASCII)
+{
+   if(font != ASCII_8X16_System || !ASCII_FONT_SYSTEM)
+   {
+      font = ASCII_8X16_MS_Gothic;
+   }
+   if(ASCII < ASCII_FIRST_CHAR || ASCII > ASCII_LAST_CHAR)
+   {
+      ASCII = ASCII_FALLBACK_CHAR;
+   }
+   return AsciiLib[font][ASCII - ASCII_FIRST_CHAR];
 }
 
 
@@ -29,8 +29,27 @@
 #define  ASCII_8X16_MS_Gothic   0
 #define  ASCII_8X16_System      1
 
+/* System font is not used by the firmware, set to 1 to compile it in */
+#ifndef ASCII_FONT_SYSTEM
+#define  ASCII_FONT_SYSTEM      0
+#endif
+
+#if ASCII_FONT_SYSTEM
+#define  ASCII_FONTS            2
+#else
+#define  ASCII_FONTS            1
+#endif
+
+#define  ASCII_GLYPH_WIDTH      8
+#define  ASCII_GLYPH_HEIGHT     16
+#define  ASCII_GLYPH_ADVANCE    10  /* pen step of a text run, glyph and gap */
+#define  ASCII_FIRST_CHAR       32
+#define  ASCII_LAST_CHAR        126
+#define  ASCII_FALLBACK_CHAR    '?'
+
 /* Private function prototypes -----------------------------------------------*/
 void GetASCIICode(int font, unsigned char* pBuffer,unsigned char ASCII);
+const unsigned char* GetASCIIGlyph(int font, unsigned char ASCII);
 
 #endif
 
@@ -0,0 +1,28 @@
+#ifndef __CYCLE_COUNTER_H
+#define __CYCLE_COUNTER_H
+
+#include <LPC17xx.h>
+
+/*****************************
+ *  Starts DWT->CYCCNT, which only counts with trace
+ *  enabled. Leaves the count running, so any module
+ *  using the counter may call it
+ */
+static inline void cycleCounterEnable(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*****************************
+ *  Busy waits until cycles passed since a
+ *  DWT->CYCCNT stamp, returns at once when
+ *  they already did. Inline, so bus code can
+ *  wait per word without a call
+ */
+static inline void cycleCounterWaitSince(uint32_t since, uint32_t cycles)
+{
+	while(DWT->CYCCNT - since < cycles);
+}
+
+#endif
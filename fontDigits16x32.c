@@ -0,0 +1,23 @@
+/* Generated by tools/fontgen.py --chars 0-9 --scale 2 --name FONT_DIGITS_16X32, do not edit */
+/* 10 glyphs, 421 bytes of runs, 640 bytes as 1bpp bitmap */
+
+#include "packedFont.h"
+
+static const uint8_t RUNS[] = {
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0x96,0xB4,0xFF,0xFF,0xC0,  // '0'
+	0xFF,0x82,0xD3,0xA6,0xA6,0xD3,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xFF,0xFF,0xC0,  // '1'
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0xE2,0xD3,0xC3,0xD2,0xE2,0xD3,0xC3,0xC3,0xC3,0xD2,0xE2,0xD3,0xC3,0xC3,0xC2,0xE2,0xEC,0x5B,0xFF,0xFF,0x80,  // '2'
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0xE2,0xD3,0xC3,0xC3,0xA4,0xC4,0xF0,0x3E,0x3E,0x3E,0x24,0x28,0x24,0x28,0x24,0x28,0x24,0x36,0x35,0x34,0x37,0x32,0x39,0x6B,0x4F,0xFF,0xFC,  // '3'
+	0xFF,0xA2,0xE2,0xE2,0xD3,0xD3,0xC4,0xC4,0xB1,0x13,0xA2,0x22,0xA2,0x22,0xA2,0x22,0x93,0x22,0x83,0x32,0x82,0x42,0x82,0x42,0x73,0x42,0x62,0x62,0x62,0x54,0x5C,0x5B,0xB4,0xD2,0xE2,0xE2,0xE2,0xE2,0xFF,0xFF,0xA0,  // '4'
+	0xFF,0x3B,0x4C,0x43,0xD2,0xE2,0xE2,0xE2,0xE2,0xE2,0x24,0x82,0x25,0x75,0x23,0x64,0x43,0x53,0x63,0x42,0x82,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0x96,0xB4,0xFF,0xFF,0xC0,  // '5'
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0xE2,0xE2,0x24,0x82,0x25,0x75,0x23,0x64,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0x96,0xB4,0xFF,0xFF,0xC0,  // '6'
+	0xFF,0x2B,0x5C,0xD3,0xE2,0xE2,0xD3,0xC3,0xD2,0xE2,0xE2,0xE2,0xD3,0xC3,0xD2,0xE2,0xE2,0xE2,0xD3,0xC3,0xD2,0xE2,0xE2,0xE2,0xE2,0xE2,0xE2,0xFF,0xFF,0xE0,  // '7'
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0xA4,0xC4,0xA3,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0x96,0xB4,0xFF,0xFF,0xC0,  // '8'
+	0xFF,0x64,0xB6,0x93,0x23,0x73,0x43,0x53,0x63,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x44,0x63,0x25,0x75,0x22,0x84,0x22,0xE2,0xE2,0x42,0x82,0x42,0x82,0x42,0x82,0x43,0x63,0x53,0x43,0x73,0x23,0x96,0xB4,0xFF,0xFF,0xC0,  // '9'
+};
+
+static const uint16_t OFFSETS[] = {0,52,82,118,160,201,241,291,321,371};
+
+const struct PackedFont FONT_DIGITS_16X32 = {
+	16, 32, '0', '9', OFFSETS, RUNS
+};
@@ -0,0 +1,53 @@
+#ifndef __KEY_EVENT_RING_H
+#define __KEY_EVENT_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <LPC17xx.h>
+#include "keypad.h"
+
+/* Single producer, single consumer ring, lock free so the producer may also be an ISR.
+ * Indices run freely, each is written by one side only */
+struct KeyEventRing{
+	struct KeyEvent events[KEYPAD_EVENT_RING_LEN];
+	volatile uint32_t head;  // producer
+	volatile uint32_t tail;  // consumer
+	uint32_t dropped;        // producer
+};
+
+/*****************************
+ *  Producer side, false and the event
+ *  counted as dropped when the ring is full
+ */
+static inline bool keyEventRingPush(struct KeyEventRing* ring, const struct KeyEvent* event)
+{
+	uint32_t head = ring->head;
+	if(head - ring->tail == KEYPAD_EVENT_RING_LEN)
+	{
+		ring->dropped++;
+		return false;
+	}
+	ring->events[head % KEYPAD_EVENT_RING_LEN] = *event;
+	__DMB();  // event is written before it is published
+	ring->head = head + 1;
+	return true;
+}
+
+/*****************************
+ *  Consumer side, false when empty
+ */
+static inline bool keyEventRingPop(struct KeyEventRing* ring, struct KeyEvent* event)
+{
+	uint32_t tail = ring->tail;
+	if(ring->head == tail)
+	{
+		return false;
+	}
+	__DMB();  // head is read before the event
+	*event = ring->events[tail % KEYPAD_EVENT_RING_LEN];
+	__DMB();  // event is copied before its slot is freed
+	ring->tail = tail + 1;
+	return true;
+}
+
+#endif
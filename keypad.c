@@ -0,0 +1,248 @@
+#include "keypad.h"
+#include "periphPower.h"
+#include "rtosIrq.h"
+#include "cycleCounter.h"
+#include "keyEventRing.h"
+#include "lowPower.h"
+#include "GPIO_LPC17xx.h"
+#include <LPC17xx.h>
+#include <PIN_LPC17xx.h>
+
+#include <cmsis_os2.h>
+
+#define KEYPAD_FLAG_WAKE 0x0001U
+
+static const PIN ROW_PINS[] = {
+  {0U, 0U },
+  {0U, 1U },
+  {2U, 11U },
+  {2U, 12U }
+};
+
+/* All columns are on port 0, so one interrupt enable register covers them */
+static const PIN COL_PINS[] = {
+  {0U, 17U },
+  {0U, 18U },
+  {0U, 15U },
+  {0U, 16U }
+};
+
+#define KEYPAD_COL_MASK ((1U << 15) | (1U << 16) | (1U << 17) | (1U << 18))
+
+#define KEYPAD_GPIO_PORTS 5
+
+/* Row pins of each port, rows of one port are driven by a single FIOSET or FIOCLR */
+static uint32_t rowPortMasks[KEYPAD_GPIO_PORTS];
+static uint32_t scanCycles;
+static uint32_t wakeLatency;
+
+static struct KeyEventRing eventRing;
+
+static osThreadId_t keypadThreadId;
+static osThreadId_t listenerThreadId;
+static uint32_t listenerFlags;
+
+void keypadSetup()
+{
+	periphPowerAcquire(PERIPH_POWER_GPIO);  // pins and column interrupts
+	cycleCounterEnable();  // column settle waits and event timestamps
+	for(int n = 0; n < KEYPAD_ROWS; n++)
+	{
+		PIN_Configure (ROW_PINS[n].Portnum, ROW_PINS[n].Pinnum, PIN_FUNC_0, PIN_PINMODE_PULLDOWN, PIN_PINMODE_NORMAL);
+		GPIO_SetDir   (ROW_PINS[n].Portnum, ROW_PINS[n].Pinnum, GPIO_DIR_OUTPUT);
+		rowPortMasks[ROW_PINS[n].Portnum] |= 1U << ROW_PINS[n].Pinnum;
+	}
+	for(int n = 0; n < KEYPAD_COLS; n++)
+	{
+		PIN_Configure (COL_PINS[n].Portnum, COL_PINS[n].Pinnum, PIN_FUNC_0, PIN_PINMODE_PULLDOWN, PIN_PINMODE_NORMAL);
+		GPIO_SetDir   (COL_PINS[n].Portnum, COL_PINS[n].Pinnum, GPIO_DIR_INPUT);
+	}
+}
+
+static LPC_GPIO_TypeDef* gpioPort(uint32_t portnum)
+{
+	switch(portnum)
+	{
+		case 0: return LPC_GPIO0;
+		case 1: return LPC_GPIO1;
+		case 2: return LPC_GPIO2;
+		case 3: return LPC_GPIO3;
+		default: return LPC_GPIO4;
+	}
+}
+
+static void writeRows(uint32_t value)
+{
+	for(uint32_t port = 0; port < KEYPAD_GPIO_PORTS; port++)
+	{
+		if(rowPortMasks[port] == 0)
+		{
+			continue;
+		}
+		if(value)
+		{
+			gpioPort(port)->FIOSET = rowPortMasks[port];
+		}
+		else
+		{
+			gpioPort(port)->FIOCLR = rowPortMasks[port];
+		}
+	}
+}
+
+static void waitColumnsSettle()
+{
+	uint32_t start = DWT->CYCCNT;
+	uint32_t cycles = KEYPAD_SETTLE_US * (SystemCoreClock / 1000000);
+	while(DWT->CYCCNT - start < cycles);
+}
+
+/* One FIOPIN read per row, all columns are on port 0 */
+uint16_t keypadScan()
+{
+	uint16_t keys = 0;
+	for(int row = 0; row < KEYPAD_ROWS; row++)
+	{
+		writeRows(0U);
+		gpioPort(ROW_PINS[row].Portnum)->FIOSET = 1U << ROW_PINS[row].Pinnum;
+		waitColumnsSettle();
+		uint32_t pins = LPC_GPIO0->FIOPIN;
+		for(int col = 0; col < KEYPAD_COLS; col++)
+		{
+			if(pins & (1U << COL_PINS[col].Pinnum))
+			{
+				keys |= 1U << (row * KEYPAD_COLS + col);
+			}
+		}
+	}
+	return keys;
+}
+
+/* Without diodes, two rows sharing two columns close a loop through all four keys */
+bool keypadIsGhosted(uint16_t keys)
+{
+	const uint16_t rowMask = (1U << KEYPAD_COLS) - 1;
+	for(int row = 0; row < KEYPAD_ROWS; row++)
+	{
+		for(int otherRow = row + 1; otherRow < KEYPAD_ROWS; otherRow++)
+		{
+			uint16_t sharedCols = (keys >> (row * KEYPAD_COLS)) & (keys >> (otherRow * KEYPAD_COLS)) & rowMask;
+			if((sharedCols & (sharedCols - 1)) != 0)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+uint32_t keypadScanCycles()
+{
+	return scanCycles;
+}
+
+/* All rows high, so any key raises its column and fires EINT3 */
+static void armKeyInterrupt()
+{
+	writeRows(1U);
+	LPC_GPIOINT->IO0IntClr = KEYPAD_COL_MASK;
+	LPC_GPIOINT->IO0IntEnR |= KEYPAD_COL_MASK;
+	if((LPC_GPIO0->FIOPIN & KEYPAD_COL_MASK) != 0)
+	{
+		// key went down before interrupt was armed
+		osThreadFlagsSet(keypadThreadId, KEYPAD_FLAG_WAKE);
+	}
+}
+
+void EINT3_IRQHandler(void)
+{
+	lowPowerWakeHandled();
+	LPC_GPIOINT->IO0IntEnR &= ~KEYPAD_COL_MASK;
+	LPC_GPIOINT->IO0IntClr = KEYPAD_COL_MASK;
+	osThreadFlagsSet(keypadThreadId, KEYPAD_FLAG_WAKE);
+}
+
+bool keypadGetEvent(struct KeyEvent* event)
+{
+	return keyEventRingPop(&eventRing, event);
+}
+
+uint32_t keypadDroppedEvents()
+{
+	return eventRing.dropped;
+}
+
+uint32_t keypadWakeLatency()
+{
+	return wakeLatency;
+}
+
+static bool isDebouncerIdle(const struct KeypadDebouncer* debouncer, uint16_t rawKeys)
+{
+	return debouncer->stableKeys == 0 && debouncer->edgeKeys == 0 && rawKeys == 0;
+}
+
+static void keypadThread(void *argument)
+{
+	static struct KeypadDebouncer debouncer;
+	const uint32_t scanTicks = (KEYPAD_SCAN_PERIOD * osKernelGetTickFreq() + 999) / 1000;
+	uint16_t rawKeys = 0;
+	uint32_t tick = 0;
+	uint32_t wakeTick = 0;
+	bool firstEventPending = false;
+	while(1)
+	{
+		if(isDebouncerIdle(&debouncer, rawKeys))
+		{
+			armKeyInterrupt();
+			osThreadFlagsWait(KEYPAD_FLAG_WAKE, osFlagsWaitAny, osWaitForever);
+			tick = osKernelGetTickCount();
+			wakeTick = tick;
+			firstEventPending = true;
+		}
+		tick += scanTicks;
+		osDelayUntil(tick);
+
+		uint32_t scanStart = DWT->CYCCNT;
+		uint16_t keys = keypadScan();
+		scanCycles = DWT->CYCCNT - scanStart;
+		if(!keypadIsGhosted(keys))
+		{
+			rawKeys = keys;  // ambiguous scans keep the last trusted keys
+		}
+		static struct KeyEvent events[KEYPAD_KEYS];  // 192 B, not on the default size stack
+		int eventCount = keypadDebounce(&debouncer, rawKeys, events, KEYPAD_KEYS);
+		for(int n = 0; n < eventCount; n++)
+		{
+			events[n].timestamp = DWT->CYCCNT;
+			keyEventRingPush(&eventRing, &events[n]);
+		}
+		if(eventCount > 0 && firstEventPending)
+		{
+			wakeLatency = (osKernelGetTickCount() - wakeTick) * 1000 / osKernelGetTickFreq();
+			firstEventPending = false;
+		}
+		if(eventCount > 0 && listenerThreadId != NULL)
+		{
+			osThreadFlagsSet(listenerThreadId, listenerFlags);
+		}
+	}
+}
+
+void keypadStart()
+{
+	static const osThreadAttr_t keypadThreadAttr = {
+		.name = "keypad",
+		.priority = osPriorityAboveNormal
+	};
+	keypadThreadId = osThreadNew(keypadThread, NULL, &keypadThreadAttr);
+
+	NVIC_SetPriority(EINT3_IRQn, RTOS_IRQ_PRIORITY);
+	NVIC_EnableIRQ(EINT3_IRQn);
+}
+
+void keypadSetListener(osThreadId_t thread, uint32_t flags)
+{
+	listenerFlags = flags;
+	listenerThreadId = thread;
+}
@@ -0,0 +1,105 @@
+#ifndef __KEYPAD_H
+#define __KEYPAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cmsis_os2.h>
+
+#define KEYPAD_ROWS 4
+#define KEYPAD_COLS 4
+#define KEYPAD_KEYS (KEYPAD_ROWS * KEYPAD_COLS)
+
+/* Period of key scanning while any key is held [ms] */
+#define KEYPAD_SCAN_PERIOD 10
+/* Time a key has to stay changed to be reported [ms] */
+#define KEYPAD_DEBOUNCE_TIME 30
+/* Hold time before first auto-repeat, 0 disables auto-repeat [ms] */
+#define KEYPAD_REPEAT_DELAY 800
+/* Time between auto-repeats [ms] */
+#define KEYPAD_REPEAT_PERIOD 200
+/* Queued events, power of two */
+#define KEYPAD_EVENT_RING_LEN 32
+/* Column discharge through pull-downs after a row goes low [us] */
+#define KEYPAD_SETTLE_US 2
+
+/* Key index is row * KEYPAD_COLS + col */
+struct KeyEvent{
+	uint8_t key;
+	bool pressed;
+	bool repeat;
+	uint16_t latency;  // from first seen edge to event [ms]
+	uint32_t timestamp;  // DWT->CYCCNT when queued
+};
+
+/* Per key debounce and repeat state, advanced once per scan tick */
+struct KeypadDebouncer{
+	uint16_t stableKeys;
+	uint16_t edgeKeys;                   // first edge seen, no event yet
+	uint16_t edgeTime[KEYPAD_KEYS];      // since first edge, kept over bounces
+	uint16_t bounceTime[KEYPAD_KEYS];    // back at stable state since
+	uint16_t changedTime[KEYPAD_KEYS];   // away from stable state since
+	uint16_t heldTime[KEYPAD_KEYS];
+};
+
+/*****************************
+ *  Pins configuration, before kernel start
+ */
+void keypadSetup(void);
+
+/*****************************
+ *  Creates event queue and scan task,
+ *  after osKernelInitialize
+ */
+void keypadStart(void);
+
+/*****************************
+ *  Thread flags set on thread after new events
+ *  were queued, the thread is the only consumer
+ *  of keypadGetEvent
+ */
+void keypadSetListener(osThreadId_t thread, uint32_t flags);
+
+/*****************************
+ *  Bitmask of held keys, bit n is key index n,
+ *  any number of keys
+ */
+uint16_t keypadScan(void);
+
+/*****************************
+ *  True when two rows share two held columns. Three
+ *  held corners of that rectangle make the fourth
+ *  read as held too, so any of the four may be a ghost
+ */
+bool keypadIsGhosted(uint16_t keys);
+
+/*****************************
+ *  DWT cycles of the last keypadScan
+ *  of the scan task
+ */
+uint32_t keypadScanCycles(void);
+
+/*****************************
+ *  Feeds one scan of raw keys to debouncer,
+ *  writes up to maxEvents events, returns their count
+ */
+int keypadDebounce(struct KeypadDebouncer* debouncer, uint16_t rawKeys, struct KeyEvent* events, int maxEvents);
+
+/*****************************
+ *  Takes next key down or key up event,
+ *  returns false when none is queued, never blocks
+ */
+bool keypadGetEvent(struct KeyEvent* event);
+
+/*****************************
+ *  Events lost because the consumer fell
+ *  KEYPAD_EVENT_RING_LEN events behind
+ */
+uint32_t keypadDroppedEvents(void);
+
+/*****************************
+ *  Time from the key interrupt waking the idle
+ *  scan task to its first key event [ms]
+ */
+uint32_t keypadWakeLatency(void);
+
+#endif
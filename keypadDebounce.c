@@ -0,0 +1,62 @@
+#include "keypad.h"
+
+/* Time counters stop at their maximum instead of wrapping */
+static uint16_t addScanPeriod(uint16_t time)
+{
+	return time > UINT16_MAX - KEYPAD_SCAN_PERIOD ? UINT16_MAX : time + KEYPAD_SCAN_PERIOD;
+}
+
+int keypadDebounce(struct KeypadDebouncer* debouncer, uint16_t rawKeys, struct KeyEvent* events, int maxEvents)
+{
+	int eventCount = 0;
+	for(int key = 0; key < KEYPAD_KEYS && eventCount < maxEvents; key++)
+	{
+		uint16_t keyMask = 1U << key;
+		bool raw = (rawKeys & keyMask) != 0;
+		bool stable = (debouncer->stableKeys & keyMask) != 0;
+		if(raw != stable)
+		{
+			debouncer->edgeKeys |= keyMask;
+			debouncer->edgeTime[key] = addScanPeriod(debouncer->edgeTime[key]);
+			debouncer->bounceTime[key] = 0;
+			debouncer->changedTime[key] += KEYPAD_SCAN_PERIOD;
+			if(debouncer->changedTime[key] >= KEYPAD_DEBOUNCE_TIME)
+			{
+				struct KeyEvent event = {key, raw, false, debouncer->edgeTime[key], 0};
+				events[eventCount++] = event;
+				debouncer->stableKeys ^= keyMask;
+				debouncer->edgeKeys &= ~keyMask;
+				debouncer->edgeTime[key] = 0;
+				debouncer->changedTime[key] = 0;
+				debouncer->heldTime[key] = 0;
+			}
+		}
+		else
+		{
+			debouncer->changedTime[key] = 0;  // bounce, start over
+			if(debouncer->edgeKeys & keyMask)
+			{
+				// first edge is kept over bounces, back for the debounce time it was a glitch
+				debouncer->edgeTime[key] = addScanPeriod(debouncer->edgeTime[key]);
+				debouncer->bounceTime[key] += KEYPAD_SCAN_PERIOD;
+				if(debouncer->bounceTime[key] >= KEYPAD_DEBOUNCE_TIME)
+				{
+					debouncer->edgeKeys &= ~keyMask;
+					debouncer->edgeTime[key] = 0;
+					debouncer->bounceTime[key] = 0;
+				}
+			}
+			if(stable && KEYPAD_REPEAT_DELAY != 0)
+			{
+				debouncer->heldTime[key] += KEYPAD_SCAN_PERIOD;
+				if(debouncer->heldTime[key] >= KEYPAD_REPEAT_DELAY)
+				{
+					struct KeyEvent event = {key, true, true, 0, 0};
+					events[eventCount++] = event;
+					debouncer->heldTime[key] -= KEYPAD_REPEAT_PERIOD;
+				}
+			}
+		}
+	}
+	return eventCount;
+}
@@ -0,0 +1,165 @@
+#include "lcdCanvas.h"
+#include "Open1768_LCD.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define LCD_CANVAS_TILES_X (LCD_MAX_X / LCD_CANVAS_TILE)
+#define LCD_CANVAS_TILES_Y (LCD_MAX_Y / LCD_CANVAS_TILE)
+#define LCD_CANVAS_TILE_BYTES (LCD_CANVAS_TILE / 8)
+
+/* Both bitmaps (2 x 9600 B) are kept in the AHB SRAM bank, IRAM2 */
+static struct{
+	uint8_t drawn[LCD_MAX_Y][LCD_CANVAS_STRIDE];
+	uint8_t shown[LCD_MAX_Y][LCD_CANVAS_STRIDE];  // as last pushed to GRAM
+} canvas __attribute__((section(".bss.ARM.__at_0x2007C000")));
+
+static uint16_t palette[2] = {LCDWhite, LCDBlack};
+static bool invalidated = true;
+
+static struct{
+	uint16_t xStart;
+	uint16_t xEnd;
+	uint16_t yEnd;
+	uint16_t x;
+	uint16_t y;
+} window;
+
+void lcdCanvasOpenWindow(uint16_t xStart, uint16_t xEnd, uint16_t yStart, uint16_t yEnd)
+{
+	window.xStart = xStart;
+	window.xEnd = xEnd < LCD_MAX_X ? xEnd : LCD_MAX_X - 1;
+	window.yEnd = yEnd < LCD_MAX_Y ? yEnd : LCD_MAX_Y - 1;
+	window.x = xStart;
+	window.y = yStart;
+}
+
+static void fillSpan(uint8_t* row, uint16_t x, uint32_t length, bool set)
+{
+	while(length > 0)
+	{
+		uint8_t bitIdx = x % 8;
+		uint32_t byteLeft = 8 - bitIdx;
+		uint8_t bits = length < byteLeft ? length : byteLeft;
+		uint8_t mask = (0xFF >> bitIdx) & (0xFF << (8 - bitIdx - bits));  // MSB is left pixel
+		if(set)
+		{
+			row[x / 8] |= mask;
+		}
+		else
+		{
+			row[x / 8] &= ~mask;
+		}
+		x += bits;
+		length -= bits;
+	}
+}
+
+void lcdCanvasStreamFill(uint16_t color, uint32_t count)
+{
+	bool set = color != palette[0];
+	while(count > 0 && window.y <= window.yEnd)
+	{
+		uint32_t rowLeft = window.xEnd - window.x + 1;
+		uint32_t length = count < rowLeft ? count : rowLeft;
+		fillSpan(canvas.drawn[window.y], window.x, length, set);
+		window.x += length;
+		count -= length;
+		if(window.x > window.xEnd)
+		{
+			window.x = window.xStart;
+			window.y++;
+		}
+	}
+}
+
+void lcdCanvasSetPalette(uint16_t background, uint16_t foreground)
+{
+	palette[0] = background;
+	palette[1] = foreground;
+	invalidated = true;
+}
+
+void lcdCanvasInvalidate()
+{
+	invalidated = true;
+}
+
+static bool isTileChanged(int tileX, int tileY)
+{
+	if(invalidated)
+	{
+		return true;
+	}
+	for(int y = tileY * LCD_CANVAS_TILE; y < (tileY + 1) * LCD_CANVAS_TILE; y++)
+	{
+		if(memcmp(&canvas.drawn[y][tileX * LCD_CANVAS_TILE_BYTES], &canvas.shown[y][tileX * LCD_CANVAS_TILE_BYTES], LCD_CANVAS_TILE_BYTES) != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Adjacent changed tiles of one tile row go in one window, each run of equal pixels is one fill */
+static void pushTiles(int tileStart, int tileEnd, int tileY)
+{
+	uint16_t xStart = tileStart * LCD_CANVAS_TILE;
+	uint16_t yStart = tileY * LCD_CANVAS_TILE;
+	int byteStart = tileStart * LCD_CANVAS_TILE_BYTES;
+	int bytes = (tileEnd - tileStart) * LCD_CANVAS_TILE_BYTES;
+	lcdSetWindow(xStart, tileEnd * LCD_CANVAS_TILE - 1, yStart, yStart + LCD_CANVAS_TILE - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	bool set = false;
+	uint32_t run = 0;
+	for(int y = yStart; y < yStart + LCD_CANVAS_TILE; y++)
+	{
+		const uint8_t* row = &canvas.drawn[y][byteStart];
+		for(int x = 0; x < bytes * 8; x++)
+		{
+			bool pixel = (row[x / 8] >> (7 - x % 8)) & 1;
+			if(pixel != set)
+			{
+				if(run > 0)
+				{
+					lcdStreamFill(palette[set], run);
+				}
+				set = pixel;
+				run = 0;
+			}
+			run++;
+		}
+		memcpy(&canvas.shown[y][byteStart], row, bytes);
+	}
+	lcdStreamFill(palette[set], run);
+	lcdEndDataStream();
+}
+
+uint32_t lcdCanvasFlush()
+{
+	uint32_t pushed = 0;
+	for(int tileY = 0; tileY < LCD_CANVAS_TILES_Y; tileY++)
+	{
+		int tileX = 0;
+		while(tileX < LCD_CANVAS_TILES_X)
+		{
+			int tileStart = tileX;
+			while(tileX < LCD_CANVAS_TILES_X && isTileChanged(tileX, tileY))
+			{
+				tileX++;
+			}
+			if(tileX > tileStart)
+			{
+				pushTiles(tileStart, tileX, tileY);
+				pushed += tileX - tileStart;
+			}
+			else
+			{
+				tileX++;
+			}
+		}
+	}
+	invalidated = false;
+	return pushed;
+}
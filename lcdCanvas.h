@@ -0,0 +1,38 @@
+#ifndef __LCD_CANVAS_H
+#define __LCD_CANVAS_H
+
+#include <stdint.h>
+#include "LCD_ILI9325.h"
+
+/* Changed screen parts are pushed in square tiles of this size [px] */
+#define LCD_CANVAS_TILE 16
+#define LCD_CANVAS_STRIDE (LCD_MAX_X / 8)
+
+/*****************************
+ *  Off-screen 1 bit per pixel copy of the screen,
+ *  same coordinates as the panel in DISP_ORIENTATION.
+ *  Fills are windowed like GRAM writes, any color
+ *  other than background is drawn as foreground.
+ */
+void lcdCanvasOpenWindow(uint16_t xStart, uint16_t xEnd, uint16_t yStart, uint16_t yEnd);
+void lcdCanvasStreamFill(uint16_t color, uint32_t count);
+
+/*****************************
+ *  Colors of 0 and 1 bits,
+ *  whole screen is pushed on next flush
+ */
+void lcdCanvasSetPalette(uint16_t background, uint16_t foreground);
+
+/*****************************
+ *  Next flush pushes whole screen,
+ *  for GRAM of unknown contents
+ */
+void lcdCanvasInvalidate(void);
+
+/*****************************
+ *  Pushes tiles changed since last flush,
+ *  returns number of pushed tiles
+ */
+uint32_t lcdCanvasFlush(void);
+
+#endif
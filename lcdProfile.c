@@ -0,0 +1,26 @@
+#include "lcdProfile.h"
+
+#if LCD_PROFILE
+
+struct LcdProfileFrame lcdProfileCurrent;
+static struct LcdProfileFrame lcdProfileLast;
+
+void lcdProfileAdd(enum lcd_profile_site site, uint32_t words, uint32_t cycles)
+{
+	lcdProfileCurrent.site[site].calls += 1;
+	lcdProfileCurrent.site[site].words += words;
+	lcdProfileCurrent.site[site].cycles += cycles;
+}
+
+void lcdProfileEndFrame()
+{
+	lcdProfileLast = lcdProfileCurrent;
+	lcdProfileCurrent = (struct LcdProfileFrame){0};
+}
+
+const struct LcdProfileFrame* lcdProfileLastFrame()
+{
+	return &lcdProfileLast;
+}
+
+#endif
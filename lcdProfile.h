@@ -0,0 +1,66 @@
+#ifndef __LCD_PROFILE_H
+#define __LCD_PROFILE_H
+
+#include <stdint.h>
+
+/* Set LCD_PROFILE=1 in project defines to count LCD bus transactions */
+#ifndef LCD_PROFILE
+#define LCD_PROFILE 0
+#endif
+
+enum lcd_profile_site{
+	LCD_PROFILE_WRITE_INDEX,
+	LCD_PROFILE_WRITE_DATA,
+	LCD_PROFILE_WRITE_REG,
+	LCD_PROFILE_READ_DATA,
+	LCD_PROFILE_SET_CURSOR,
+	LCD_PROFILE_STREAM,  // lcdStreamData and lcdStreamFill
+	LCD_PROFILE_DELAY,   // busy waits of lcdDelayCycles
+	LCD_PROFILE_SITES
+};
+
+struct LcdProfileCounter{
+	uint32_t calls;
+	uint32_t words;   // data words written or read
+	uint32_t cycles;  // including nested calls
+};
+
+struct LcdProfileFrame{
+	struct LcdProfileCounter site[LCD_PROFILE_SITES];
+	uint32_t latches;  // LE pulses of the 74HC573
+};
+
+#if LCD_PROFILE
+
+#include "LPC17xx.h"
+
+/* Host builds can replace the cycle source */
+#ifndef LCD_PROFILE_CYCLES
+#define LCD_PROFILE_CYCLES() (DWT->CYCCNT)
+#endif
+
+extern struct LcdProfileFrame lcdProfileCurrent;
+
+#define LCD_PROFILE_START() uint32_t lcdProfileStart = LCD_PROFILE_CYCLES()
+#define LCD_PROFILE_STOP(site, words) lcdProfileAdd((site), (words), LCD_PROFILE_CYCLES() - lcdProfileStart)
+#define LCD_PROFILE_LATCH() (lcdProfileCurrent.latches++)
+
+void lcdProfileAdd(enum lcd_profile_site site, uint32_t words, uint32_t cycles);
+
+/*****************************
+ *  Closes current frame, its counters are
+ *  available from lcdProfileLastFrame
+ */
+void lcdProfileEndFrame(void);
+const struct LcdProfileFrame* lcdProfileLastFrame(void);
+
+#else
+
+#define LCD_PROFILE_START()
+#define LCD_PROFILE_STOP(site, words)
+#define LCD_PROFILE_LATCH()
+#define lcdProfileEndFrame()
+
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#include "lowPower.h"
+#include "FreeRTOS.h"
+#include <LPC17xx.h>
+
+#include <stdbool.h>
+
+/* Written only by the idle task, 32 bit reads are atomic */
+static volatile struct LowPowerResidency totals;
+
+/* Last sleep exit that was not for the tick, until an interrupt claims it */
+static uint32_t sleepExitStamp;
+static volatile bool sleepExitPending;
+
+#if configUSE_IDLE_HOOK
+/* SysTick counts down from LOAD, the tick interrupt ends the wait so it wraps at most once */
+static uint32_t sysTickElapsed(uint32_t start, uint32_t end)
+{
+	return start >= end ? start - end : start + (SysTick->LOAD + 1) - end;
+}
+
+/* Sleep (not deep sleep) keeps SysTick and GPIO interrupts, any interrupt wakes the core.
+ * Only without tickless idle, which sleeps in the port instead */
+void vApplicationIdleHook(void)
+{
+	uint32_t start = SysTick->VAL;
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+	__DSB();
+	__WFI();
+	totals.idleCycles += sysTickElapsed(start, SysTick->VAL);
+}
+#endif
+
+void lowPowerSleepEnter()
+{
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+	sleepExitPending = false;
+}
+
+void lowPowerSleepExit()
+{
+	// port restarted SysTick from LOAD before WFI, pending tick means the whole period passed
+	uint32_t elapsed = SysTick->LOAD - SysTick->VAL;
+	bool tickWake = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+	if(tickWake)
+	{
+		elapsed += SysTick->LOAD + 1;
+	}
+	totals.sleepCycles += elapsed;
+	sleepExitStamp = DWT->CYCCNT;
+	sleepExitPending = !tickWake;
+}
+
+void lowPowerWakeHandled()
+{
+	if(sleepExitPending)
+	{
+		totals.wakeCycles = DWT->CYCCNT - sleepExitStamp;
+		sleepExitPending = false;
+	}
+}
+
+void lowPowerGetResidency(struct LowPowerResidency* residency)
+{
+	residency->idleCycles = totals.idleCycles;
+	residency->sleepCycles = totals.sleepCycles;
+	residency->wakeCycles = totals.wakeCycles;
+}
@@ -0,0 +1,35 @@
+#ifndef __LOW_POWER_H
+#define __LOW_POWER_H
+
+#include <stdint.h>
+
+/* Running totals of core clock cycles spent in each low power state,
+ * wrap after 2^32 cycles, so read them at least every 40 s */
+struct LowPowerResidency{
+	uint32_t idleCycles;   // WFI in idle hook, tick running, only without tickless idle
+	uint32_t sleepCycles;  // WFI in tickless idle, tick suppressed
+	uint32_t wakeCycles;   // last sleep exit to the handler of the interrupt that ended it
+};
+
+/*****************************
+ *  configPRE_SLEEP_PROCESSING,
+ *  interrupts are masked until after the exit
+ */
+void lowPowerSleepEnter(void);
+
+/*****************************
+ *  configPOST_SLEEP_PROCESSING,
+ *  SysTick still runs the suppressed period
+ */
+void lowPowerSleepExit(void);
+
+/*****************************
+ *  First thing of a handler whose interrupt wakes the
+ *  core, takes the wake latency when this interrupt
+ *  ended the last sleep. Needs the DWT cycle counter
+ */
+void lowPowerWakeHandled(void);
+
+void lowPowerGetResidency(struct LowPowerResidency* residency);
+
+#endif
@@ -1,48 +1,54 @@
 #include "LCD_ILI9325.h"
 #include "Open1768_LCD.h"
 #include "asciiLib.h"
+#include "keypad.h"
+#include "lcdProfile.h"
+#include "packedFont.h"
+#include "lcdCanvas.h"
+#include "lowPower.h"
+#include "periphPower.h"
+#include "rtosIrq.h"
 #include <stdbool.h> 
 #include "GPIO_LPC17xx.h"
 #include <LPC17xx.h>
 #include <PIN_LPC17xx.h>
 
 #include <cmsis_os2.h>
+#include "FreeRTOS.h"
 
 #define MAX_COL_IDX 7
-#define LETTER_HEIGHT 16
-#define LETTER_WIDTH 8
+#define LETTER_HEIGHT ASCII_GLYPH_HEIGHT
+#define LETTER_WIDTH ASCII_GLYPH_WIDTH
+#define LETTER_ADVANCE ASCII_GLYPH_ADVANCE
 
 enum lock_state{
 	LOCKED,
 	UNLOCKED,
 	NEW_CODE
 };
-osTimerId_t timer0;
-enum lock_state LOCK_STATE = LOCKED;
+/* Time after unlock until the lock closes again [ms] */
+#define RELOCK_TIMEOUT_MS 10000
+
+/* Created once with static memory, restarted on every unlock */
+static StaticTimer_t relockTimerMemory;
+osTimerId_t relockTimer;
+
+/* Lock state below is owned by the logic task */
+static enum lock_state LOCK_STATE = LOCKED;
 
 #define CODE_LEN 4
-int ENTERED_CODE[CODE_LEN] = {-1, -1, -1, -1};
-int codeInputCounter = 0;
+static int ENTERED_CODE[CODE_LEN] = {-1, -1, -1, -1};
+static int codeInputCounter = 0;
 
-int PASSCODE[CODE_LEN] = {1,2,3,4};
-int passcodeInputCounter = 0;
+static int PASSCODE[CODE_LEN] = {1,2,3,4};
+static int passcodeInputCounter = 0;
 
-const int CodeXPos = LCD_MAX_X / 2 - (2 * LETTER_WIDTH);
-const int CodeYPos = LCD_MAX_Y / 2 - LETTER_HEIGHT;  // 1 over state
+static char KEY_ECHO = ' ';
 
-static const PIN ROW_PINS[] = {
-  {0U, 0U },
-  {0U, 1U },
-  {2U, 11U },
-  {2U, 12U }
-};
+#define LOGIC_FLAG_KEY    0x0001U
+#define LOGIC_FLAG_RELOCK 0x0002U
 
-static const PIN COL_PINS[] = {
-  {0U, 17U },
-  {0U, 18U },
-  {0U, 15U },
-  {0U, 16U }
-};
+osThreadId_t logicThreadId;
 
 static const PIN LED_PIN[] = {
   {0U, 3U },
@@ -80,30 +86,97 @@ struct Date{
 	int sec;
 };
 
-struct Date LAST_STATE_CHANGE = {0, 0, 0, 0, 0, 0};
+static struct Date LAST_STATE_CHANGE = {0, 0, 0, 0, 0, 0};
+
+/* Copy of lock state published by the logic task for the display task */
+struct LockSnapshot{
+	enum lock_state state;
+	int code[CODE_LEN];  // entered code, new passcode while in NEW_CODE
+	char keyEcho;
+	struct Date lastStateChange;
+};
+
+static struct LockSnapshot LOCK_SNAPSHOT = {LOCKED, {-1, -1, -1, -1}, ' ', {0, 0, 0, 0, 0, 0}};
+osMutexId_t snapshotMutex;
+
+/* Screen regions to redraw, the display task sleeps until one is set */
+#define DISPLAY_FLAG_KEY_ECHO    0x0001U
+#define DISPLAY_FLAG_CODE        0x0002U
+#define DISPLAY_FLAG_LOCK_STATE  0x0004U
+#define DISPLAY_FLAG_LAST_CHANGE 0x0008U
+#define DISPLAY_FLAG_CLOCK       0x0010U  // every RTC second
+#define DISPLAY_FLAG_ACTIVITY    0x0020U  // any key event, wakes the panel
+#define DISPLAY_FLAGS_ALL        0x003FU
+
+/* Panel power steps after the last key event [ms] */
+#define PANEL_DIM_TIMEOUT_MS     30000
+#define PANEL_STANDBY_TIMEOUT_MS 60000
+static uint32_t panelWakeToFrame;  // last key wake to first flushed frame [ms]
+
+static StaticEventGroup_t displayEventsMemory;
+osEventFlagsId_t displayEvents;
+
+#define TEXT_FIELD_MAX_LEN 20
+
+/* Retained screen contents of one line of text, only changed cells are repainted */
+struct TextField{
+	uint16_t xPos;
+	uint16_t yPos;
+	int length;
+	char shown[TEXT_FIELD_MAX_LEN];
+	const struct PackedFont* font;  // NULL for 8x16 ASCII font
+	int scale;                      // of 8x16 ASCII font
+	int capacity;                   // letters at most, longer text is cut
+};
+
+#define CODE_LETTER_WIDTH 16
+#define CODE_LETTER_HEIGHT 32
+#define CODE_LETTER_ADVANCE (CODE_LETTER_WIDTH + LETTER_ADVANCE - LETTER_WIDTH)
+#define KEY_ECHO_SCALE 2
+#define DATE_TEXT_LEN 20
+
+struct TextField LOCK_STATE_FIELD = {LCD_MAX_X / 2 - (4 * LETTER_WIDTH), LCD_MAX_Y / 2, 0, {0}, NULL, 1, 8};
+struct TextField ENTERED_CODE_FIELD = {LCD_MAX_X / 2 - (2 * CODE_LETTER_ADVANCE), LCD_MAX_Y / 2 - CODE_LETTER_HEIGHT - LETTER_HEIGHT / 2, 0, {0}, &FONT_DIGITS_16X32, 1, CODE_LEN};  // 1 over state
+struct TextField KEY_ECHO_FIELD = {LCD_MAX_X / 2 - KEY_ECHO_SCALE * LETTER_WIDTH / 2, LCD_MAX_Y / 2 - CODE_LETTER_HEIGHT - (KEY_ECHO_SCALE + 1) * LETTER_HEIGHT, 0, {0}, NULL, KEY_ECHO_SCALE, 1};  // 1 over code
+struct TextField LAST_STATE_CHANGE_LABEL_FIELD = {10, LCD_MAX_Y - 90, 0, {0}, NULL, 1, 17};
+struct TextField LAST_STATE_CHANGE_FIELD = {10, LCD_MAX_Y - 70, 0, {0}, NULL, 1, DATE_TEXT_LEN};
+struct TextField CLOCK_DATE_LABEL_FIELD = {10, LCD_MAX_Y - 40, 0, {0}, NULL, 1, 12};
+struct TextField CLOCK_DATE_FIELD = {10, LCD_MAX_Y - 20, 0, {0}, NULL, 1, DATE_TEXT_LEN};
+
+#if LCD_PROFILE
+#define PROFILE_VALUES 16      // XX 000000, two per report line
+#define PROFILE_VALUE_LEN 9
+#define PROFILE_PC_LEN 11      // PC 00000000, the last field
+/* Placed by layoutProfileFields, landscape leaves no room for whole report lines */
+struct TextField PROFILE_FIELDS[PROFILE_VALUES + 1];
+#endif
+
+struct TextField* const SCREEN_FIELDS[] = {
+	&LOCK_STATE_FIELD,
+	&ENTERED_CODE_FIELD,
+	&KEY_ECHO_FIELD,
+	&LAST_STATE_CHANGE_LABEL_FIELD,
+	&LAST_STATE_CHANGE_FIELD,
+	&CLOCK_DATE_LABEL_FIELD,
+	&CLOCK_DATE_FIELD
+};
+
+/* Opens canvas window for frame, following fills cover it row by row, lcdCanvasFlush puts it on screen */
+void openWindow(const struct Frame* frame)
+{
+	lcdCanvasOpenWindow(frame->xStart, frame->xEnd, frame->yStart, frame->yEnd);
+}
 
 void draw(const struct Frame* frame, const uint16_t color)
 {
-	lcdWriteReg(HADRPOS_RAM_START, frame->xStart);
-	lcdWriteReg(HADRPOS_RAM_END, frame->xEnd);
-	lcdWriteReg(VADRPOS_RAM_START, frame->yStart);
-	lcdWriteReg(VADRPOS_RAM_END, frame->yEnd);
-	
-	lcdSetCursor(frame->xStart, frame->yStart);
-	
-	lcdWriteIndex(DATA_RAM);
-	for(int x = frame->xStart; x <= frame->xEnd; x++)
-	{
-		for(int y = frame->yStart; y <= frame->yEnd; y++)
-		{
-			lcdWriteData(color);
-		}
-	}
+	uint32_t pixels = (uint32_t)(frame->xEnd - frame->xStart + 1) * (frame->yEnd - frame->yStart + 1);
+	openWindow(frame);
+	lcdCanvasStreamFill(color, pixels);
 }
 
 void clearScreen()
 {
-	struct Frame screenWideFrame = {0, LCD_MAX_X, 0, LCD_MAX_Y};
+	struct Frame screenWideFrame = {0, LCD_MAX_X - 1, 0, LCD_MAX_Y - 1};
 
 	draw(&screenWideFrame, LCDWhite);
 }
@@ -115,88 +188,246 @@ bool shoulPixelBeDrawn(int rowValue, int column)
 
 void drawLetter(struct Frame* frame, char letter)
 {
-	unsigned char letterBuffer[16];
-	GetASCIICode(0, letterBuffer, letter);
+	const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letter);
+	struct Frame letterFrame = {
+		frame->xStart,
+		frame->xStart + LETTER_WIDTH - 1,
+		frame->yStart,
+		frame->yStart + LETTER_HEIGHT - 1
+	};
+	openWindow(&letterFrame);
 	for(int row = 0; row < LETTER_HEIGHT; row++)
 	{
 		for(int col = 0; col < LETTER_WIDTH; col++)
 		{
-			if(shoulPixelBeDrawn(letterBuffer[row], col))
+			lcdCanvasStreamFill(shoulPixelBeDrawn(glyph[row], col) ? LCDBlack : LCDWhite, 1);
+		}
+	}
+}
+
+#define TEXT_RUN_MAX_LEN 20
+
+/* One glyph row of the whole run as horizontal runs of equal color, each pixel scale wide */
+void streamGlyphRow(const unsigned char* const* glyphs, int numberOfLetters, int row, int scale)
+{
+	uint16_t color = LCDWhite;
+	uint32_t run = 0;
+	for(int letterIdx = 0; letterIdx < numberOfLetters; letterIdx++)
+	{
+		for(int col = 0; col < LETTER_WIDTH; col++)
+		{
+			uint16_t pixelColor = shoulPixelBeDrawn(glyphs[letterIdx][row], col) ? LCDBlack : LCDWhite;
+			if(pixelColor != color)
 			{
-				lcdWriteReg(ADRX_RAM, frame->xStart + col);
-				lcdWriteReg(ADRY_RAM, frame->yStart + row);
-				lcdWriteReg(DATA_RAM, LCDBlack);
+				if(run > 0)
+				{
+					lcdCanvasStreamFill(color, run);
+				}
+				color = pixelColor;
+				run = 0;
 			}
+			run += scale;
 		}
+		if(color != LCDWhite)
+		{
+			lcdCanvasStreamFill(color, run);
+			color = LCDWhite;
+			run = 0;
+		}
+		run += (LETTER_ADVANCE - LETTER_WIDTH) * scale;  // gap
 	}
+	lcdCanvasStreamFill(color, run);
 }
 
-void writeLetters(const char* letters, const struct Frame* startingPossition, const int numberOfLetters)
+/* One window for the whole run, every glyph row is repeated scale times */
+void streamTextRun(uint16_t xPos, uint16_t yPos, const char* letters, int numberOfLetters, int scale)
 {
-	struct Frame letterPossition = {
-		startingPossition->xStart,
-		startingPossition->xEnd,
-		startingPossition->yStart,
-		startingPossition->yEnd
+	const unsigned char* glyphs[TEXT_RUN_MAX_LEN];
+	for(int letterIdx = 0; letterIdx < numberOfLetters; letterIdx++)
+	{
+		glyphs[letterIdx] = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letters[letterIdx]);
+	}
+	struct Frame runFrame = {
+		xPos,
+		xPos + numberOfLetters * LETTER_ADVANCE * scale - 1,
+		yPos,
+		yPos + LETTER_HEIGHT * scale - 1
+	};
+	openWindow(&runFrame);
+	for(int row = 0; row < LETTER_HEIGHT; row++)
+	{
+		for(int repeat = 0; repeat < scale; repeat++)
+		{
+			streamGlyphRow(glyphs, numberOfLetters, row, scale);
+		}
+	}
+}
+
+void drawScaledTextRun(uint16_t xPos, uint16_t yPos, const char* letters, int numberOfLetters, int scale)
+{
+	while(numberOfLetters > 0)
+	{
+		int runLength = numberOfLetters < TEXT_RUN_MAX_LEN ? numberOfLetters : TEXT_RUN_MAX_LEN;
+		streamTextRun(xPos, yPos, letters, runLength, scale);
+		xPos += runLength * LETTER_ADVANCE * scale;
+		letters += runLength;
+		numberOfLetters -= runLength;
+	}
+}
+
+void drawTextRun(uint16_t xPos, uint16_t yPos, const char* letters, int numberOfLetters)
+{
+	drawScaledTextRun(xPos, yPos, letters, numberOfLetters, 1);
+}
+
+void drawText(uint16_t xPos, uint16_t yPos, const char* text)
+{
+	drawTextRun(xPos, yPos, text, strlen(text));
+}
+
+/* Decodes font runs into the glyph window, runs are 4 bit, high nibble first */
+void drawPackedLetter(uint16_t xPos, uint16_t yPos, const struct PackedFont* font, char letter)
+{
+	const uint8_t* runs = packedFontGlyph(font, letter);
+	uint32_t pixels = (uint32_t)font->width * font->height;
+	struct Frame letterFrame = {
+		xPos,
+		xPos + font->width - 1,
+		yPos,
+		yPos + font->height - 1
 	};
+	openWindow(&letterFrame);
+	if(runs == NULL)
+	{
+		lcdCanvasStreamFill(LCDWhite, pixels);  // blank cell
+	}
+	else
+	{
+		uint16_t color = LCDWhite;
+		uint32_t run = 0;
+		for(int nibbleIdx = 0; pixels > 0; nibbleIdx++)
+		{
+			uint8_t length = (runs[nibbleIdx / 2] >> ((nibbleIdx % 2) ? 0 : 4)) & 0x0F;
+			run += length;
+			if(length != PACKED_FONT_RUN_CONTINUE)
+			{
+				lcdCanvasStreamFill(color, run);
+				pixels -= run;
+				run = 0;
+				color = color == LCDWhite ? LCDBlack : LCDWhite;
+			}
+		}
+	}
+}
+
+void drawPackedTextRun(uint16_t xPos, uint16_t yPos, const struct PackedFont* font, const char* letters, int numberOfLetters)
+{
 	for(int letterIdx = 0; letterIdx < numberOfLetters; letterIdx++)
 	{
-		drawLetter(&letterPossition, letters[letterIdx]);
-		letterPossition.xStart += 10;
-		letterPossition.xEnd += 10;
+		// gaps are never drawn over, so only glyph cells are streamed
+		drawPackedLetter(xPos + letterIdx * (font->width + LETTER_ADVANCE - LETTER_WIDTH), yPos, font, letters[letterIdx]);
 	}
 }
 
-void gpioSetup()
+void writeLetters(const char* letters, const struct Frame* startingPossition, const int numberOfLetters)
+{
+	drawTextRun(startingPossition->xStart, startingPossition->yStart, letters, numberOfLetters);
+}
+
+void updateTextField(struct TextField* field, const char* letters, const int numberOfLetters)
 {
-	for(int n = 0; n < 4; n++)
+	int length = numberOfLetters < field->capacity ? numberOfLetters : field->capacity;
+	int cells = length > field->length ? length : field->length;
+	int runStart = -1;
+	for(int letterIdx = 0; letterIdx <= cells; letterIdx++)
 	{
-		PIN_Configure (ROW_PINS[n].Portnum, ROW_PINS[n].Pinnum, PIN_FUNC_0, PIN_PINMODE_PULLDOWN, PIN_PINMODE_NORMAL);
-		GPIO_SetDir   (ROW_PINS[n].Portnum, ROW_PINS[n].Pinnum, GPIO_DIR_OUTPUT);
+		bool changed = false;
+		if(letterIdx < cells)
+		{
+			char letter = letterIdx < length ? letters[letterIdx] : ' ';
+			char shown = letterIdx < field->length ? field->shown[letterIdx] : ' ';
+			changed = letter != shown;
+			field->shown[letterIdx] = letter;
+		}
+		if(changed && runStart == -1)
+		{
+			runStart = letterIdx;
+		}
+		else if(!changed && runStart != -1)
+		{
+			// changed cells are redrawn as one run
+			if(field->font != NULL)
+			{
+				int advance = field->font->width + LETTER_ADVANCE - LETTER_WIDTH;
+				drawPackedTextRun(field->xPos + runStart * advance, field->yPos, field->font, &field->shown[runStart], letterIdx - runStart);
+			}
+			else
+			{
+				drawScaledTextRun(field->xPos + runStart * LETTER_ADVANCE * field->scale, field->yPos, &field->shown[runStart], letterIdx - runStart, field->scale);
+			}
+			runStart = -1;
+		}
 	}
-	for(int n = 0; n < 4; n++)
+	field->length = length;
+}
+
+/* Screen rectangle the field covers at its full capacity */
+void textFieldFrame(const struct TextField* field, struct Frame* frame)
+{
+	int width = field->font != NULL
+		? (field->capacity - 1) * (field->font->width + LETTER_ADVANCE - LETTER_WIDTH) + field->font->width
+		: field->capacity * LETTER_ADVANCE * field->scale;  // runs end with a gap
+	int height = field->font != NULL ? field->font->height : LETTER_HEIGHT * field->scale;
+	frame->xStart = field->xPos;
+	frame->xEnd = field->xPos + width - 1;
+	frame->yStart = field->yPos;
+	frame->yEnd = field->yPos + height - 1;
+}
+
+/* Forget retained contents, to be called after the whole screen was cleared */
+void invalidateScreen()
+{
+	for(unsigned int fieldIdx = 0; fieldIdx < sizeof(SCREEN_FIELDS) / sizeof(SCREEN_FIELDS[0]); fieldIdx++)
 	{
-		PIN_Configure (COL_PINS[n].Portnum, COL_PINS[n].Pinnum, PIN_FUNC_0, PIN_PINMODE_PULLDOWN, PIN_PINMODE_NORMAL);
-		GPIO_SetDir   (COL_PINS[n].Portnum, COL_PINS[n].Pinnum, GPIO_DIR_INPUT);
+		SCREEN_FIELDS[fieldIdx]->length = 0;
 	}
+}
+
+void gpioSetup()
+{
+	keypadSetup();
 	
+	periphPowerAcquire(PERIPH_POWER_GPIO);
 	PIN_Configure (LED_PIN[0].Portnum, LED_PIN[0].Pinnum, PIN_FUNC_0, PIN_PINMODE_PULLDOWN, PIN_PINMODE_NORMAL);
 	GPIO_SetDir   (LED_PIN[0].Portnum, LED_PIN[0].Pinnum, GPIO_DIR_OUTPUT);
 }
 
-int keyboardScan()
+int waitForKeyPress()
 {
-	for(int row = 0; row < 4; row++)
+	struct KeyEvent event;
+	do
 	{
-		for(int i = 0; i < 4; i++) GPIO_PinWrite (ROW_PINS[i].Portnum, ROW_PINS[i].Pinnum, 0U);
-		
-		GPIO_PinWrite (ROW_PINS[row].Portnum, ROW_PINS[row].Pinnum, 1U);
-		for(int col = 0; col < 4; col++)
+		while(!keypadGetEvent(&event))
 		{
-			if(GPIO_PinRead (COL_PINS[col].Portnum, COL_PINS[col].Pinnum) == 1)
-				return row * 4 + col;
+			osThreadFlagsWait(LOGIC_FLAG_KEY, osFlagsWaitAny, osWaitForever);
 		}
-	}
-	return -1;
+	} while (!event.pressed || event.repeat);
+	return event.key;
 }
 
 void debugKeypadPrint()
 {
-	char lettersCol[4] = {
-		GPIO_PinRead (COL_PINS[0].Portnum, COL_PINS[0].Pinnum)+ '0',
-		GPIO_PinRead (COL_PINS[1].Portnum, COL_PINS[1].Pinnum)+ '0',
-		GPIO_PinRead (COL_PINS[2].Portnum, COL_PINS[2].Pinnum)+ '0',
-		GPIO_PinRead (COL_PINS[3].Portnum, COL_PINS[3].Pinnum)+ '0'};
-	struct Frame letterFrameRow = {50, 50 + LETTER_WIDTH, 50, 50 + LETTER_HEIGHT};
-	writeLetters(lettersCol, &letterFrameRow, 4);
-
-	char lettersRow[4] = {
-		GPIO_PinRead (ROW_PINS[0].Portnum, ROW_PINS[0].Pinnum)+ '0',
-		GPIO_PinRead (ROW_PINS[1].Portnum, ROW_PINS[1].Pinnum)+ '0',
-		GPIO_PinRead (ROW_PINS[2].Portnum, ROW_PINS[2].Pinnum)+ '0',
-		GPIO_PinRead (ROW_PINS[3].Portnum, ROW_PINS[3].Pinnum)+ '0'};
-		struct Frame letterFrameCol = {50, 50 + LETTER_WIDTH, 90, 90 + LETTER_HEIGHT};
-	writeLetters(lettersRow, &letterFrameCol, 4);
+	uint16_t keys = keypadScan();
+	for(int row = 0; row < KEYPAD_ROWS; row++)
+	{
+		char lettersCol[KEYPAD_COLS];
+		for(int col = 0; col < KEYPAD_COLS; col++)
+		{
+			lettersCol[col] = ((keys >> (row * KEYPAD_COLS + col)) & 1U) + '0';
+		}
+		struct Frame letterFrameRow = {50, 50 + LETTER_WIDTH, 50 + row * 20, 50 + row * 20 + LETTER_HEIGHT};
+		writeLetters(lettersCol, &letterFrameRow, KEYPAD_COLS);
+	}
 }
 
 
@@ -230,8 +461,28 @@ void resetPasscode()
 	passcodeInputCounter = 0;
 }
 
-void callback(void *param){
-	LOCK_STATE = LOCKED;
+void relockCallback(void *param){
+	osThreadFlagsSet(logicThreadId, LOGIC_FLAG_RELOCK);
+}
+
+void displayEventsSetup()
+{
+	static const osEventFlagsAttr_t displayEventsAttr = {
+		.name = "display",
+		.cb_mem = &displayEventsMemory,
+		.cb_size = sizeof(displayEventsMemory)
+	};
+	displayEvents = osEventFlagsNew(&displayEventsAttr);
+}
+
+void relockTimerSetup()
+{
+	static const osTimerAttr_t relockTimerAttr = {
+		.name = "relock",
+		.cb_mem = &relockTimerMemory,
+		.cb_size = sizeof(relockTimerMemory)
+	};
+	relockTimer = osTimerNew(&relockCallback, osTimerOnce, (void *)0, &relockTimerAttr);
 }
 
 void checkCode()
@@ -239,50 +490,41 @@ void checkCode()
 	if(isCodeOk())
 	{
 		LOCK_STATE = UNLOCKED;
-		timer0 = osTimerNew(&callback, osTimerOnce,(void *)0, NULL);
-		osTimerStart(timer0, 10000);
+		osTimerStart(relockTimer, (RELOCK_TIMEOUT_MS * osKernelGetTickFreq() + 999) / 1000);
 	}
 	resetEnteredCode();
 }
 
 void saveCode(int keyPressed)
 {
-		if( codeInputCounter == 0)
-		{
-			ENTERED_CODE[codeInputCounter] = KEYPAD_VALUES[keyPressed];
-			codeInputCounter += 1;
-		}
-		else if(ENTERED_CODE[codeInputCounter-1] != KEYPAD_VALUES[keyPressed])
-		{
-			ENTERED_CODE[codeInputCounter] = KEYPAD_VALUES[keyPressed];
-			codeInputCounter += 1;
-		}
+	ENTERED_CODE[codeInputCounter] = KEYPAD_VALUES[keyPressed];
+	codeInputCounter += 1;
 }
 
 void saveNewCode(int keyPressed)
 {
-		if( passcodeInputCounter == 0)
-		{
-			PASSCODE[passcodeInputCounter] = KEYPAD_VALUES[keyPressed];
-			passcodeInputCounter += 1;
-		}
-		else if(PASSCODE[passcodeInputCounter-1] != KEYPAD_VALUES[keyPressed])
-		{
-			PASSCODE[passcodeInputCounter] = KEYPAD_VALUES[keyPressed];
-			passcodeInputCounter += 1;
-		}
+	PASSCODE[passcodeInputCounter] = KEYPAD_VALUES[keyPressed];
+	passcodeInputCounter += 1;
 }
 
-void writeKeypadInput()
+void handleKeyEvent(const struct KeyEvent* event)
 {		
-	int keyPressed = keyboardScan();
-	struct Frame keyFrame = {LCD_MAX_X / 2, LCD_MAX_X / 2 +LETTER_WIDTH, CodeYPos - (2*LETTER_HEIGHT), CodeYPos - LETTER_HEIGHT};
-	if(keyPressed != -1)
+	if(event->repeat)
 	{
-		char symbol = KEYBOARD_MAP[keyPressed];
-		drawLetter(&keyFrame, symbol);
+		return;  // auto-repeat does not enter digits
+	}
+	int keyPressed = event->key;
+	char symbol = ' ';
+	if(event->pressed)
+	{
+		symbol = KEYBOARD_MAP[keyPressed];
 		
-		if(LOCK_STATE == LOCKED)
+		if(keyPressed == 15)  // D button
+		{
+			LOCK_STATE = NEW_CODE;
+			resetPasscode();
+		}
+		else if(LOCK_STATE == LOCKED)
 		{
 			saveCode(keyPressed);
 			if(codeInputCounter >= CODE_LEN)
@@ -299,224 +541,166 @@ void writeKeypadInput()
 			}
 		}
 	}
+	KEY_ECHO = symbol;
+}
+
+void writeKeyEcho(const struct LockSnapshot* snapshot)
+{
+	updateTextField(&KEY_ECHO_FIELD, &snapshot->keyEcho, 1);
 	//debugKeypadPrint();
 }
 
-void writeLockState()
+void writeLockState(const struct LockSnapshot* snapshot)
 {
 	static char lettersRow[3][8] = {{'L','O','C','K','E','D',' ',' '},
 																	{'U','N','L','O','C','K','E','D'},
 																	{'N','E','W',' ','C','O','D','E'},};
-	static int xPos = LCD_MAX_X / 2 - (4 * LETTER_WIDTH);
-	static int yPos = LCD_MAX_Y / 2;
-	struct Frame letterFrameCol = {xPos, xPos + LETTER_WIDTH, yPos, yPos + LETTER_HEIGHT};
-	writeLetters(lettersRow[LOCK_STATE], &letterFrameCol, 8);
+	updateTextField(&LOCK_STATE_FIELD, lettersRow[snapshot->state], 8);
 }
 
-void writeEnteredCode()
+void writeEnteredCode(const struct LockSnapshot* snapshot)
 {
-	struct Frame keyFrame = {CodeXPos, CodeXPos+LETTER_WIDTH, CodeYPos - LETTER_HEIGHT, CodeYPos};
-	for(int digit = 0; digit < CODE_LEN; digit++)
+	char codeLetters[CODE_LEN] = {' ', ' ', ' ', ' '};
+	if(snapshot->state != UNLOCKED)
 	{
-		if(LOCK_STATE == LOCKED)
-		{
-			if(ENTERED_CODE[digit] == -1)
-			{
-				break;
-			}
-			else
-			{
-				drawLetter(&keyFrame, CHAR[ENTERED_CODE[digit]]);
-				keyFrame.xStart += 10;
-				keyFrame.xEnd += 10;
-			}
-		}
-		else if(LOCK_STATE == NEW_CODE)
+		for(int digit = 0; digit < CODE_LEN; digit++)
 		{
-			if(PASSCODE[digit] == -1)
+			if(snapshot->code[digit] == -1)
 			{
 				break;
 			}
-			else
-			{
-				drawLetter(&keyFrame, CHAR[PASSCODE[digit]]);
-				keyFrame.xStart += 10;
-				keyFrame.xEnd += 10;
-			}
+			codeLetters[digit] = CHAR[snapshot->code[digit]];
 		}
 	}
+	updateTextField(&ENTERED_CODE_FIELD, codeLetters, CODE_LEN);
 }
 
 //real time clock
 void configure_lpc_rtc()
 {
+		periphPowerAcquire(PERIPH_POWER_RTC);  // kept, date is read also in panel standby
 		LPC_RTC->CCR = 1; // clock control register, wlaczenie zegara
 }
 
-void writeYear(struct Frame* dateFrame, int inputYear)
-{
-	static const int numberOfValues = 5;
-	int year = inputYear;
-	int ones = year % 10;
-	year /= 10;
-	int tens = year % 10;
-	year /= 10;
-	int hundread = year % 10;
-	year /= 10;
-	int thousand = year;
-	char dateValues[numberOfValues] = {
-		 thousand + '0',
-		 hundread + '0',
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
-}
-
-void writeMonth(struct Frame* dateFrame, int inputMon)
-{
-	static const int numberOfValues = 3;
-	int value = inputMon;
-	int ones = value % 10;
-	value /= 10;
-	int tens = value % 10;
-	char dateValues[numberOfValues] = {
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
-}
-
-void writeDay(struct Frame* dateFrame, int inputDay)
-{
-	static const int numberOfValues = 3;
-	int value = inputDay;
-	int ones = value % 10;
-	value /= 10;
-	int tens = value % 10;
-	char dateValues[numberOfValues] = {
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
-}
-
-void writeHour(struct Frame* dateFrame, int inputHour)
-{
-	static const int numberOfValues = 3;
-	int value = inputHour;
-	int ones = value % 10;
-	value /= 10;
-	int tens = value % 10;
-	char dateValues[numberOfValues] = {
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
-}
-
-void writeMinute(struct Frame* dateFrame, int inputMin)
-{
-	static const int numberOfValues = 3;
-	int value = inputMin;
-	int ones = value % 10;
-	value /= 10;
-	int tens = value % 10;
-	char dateValues[numberOfValues] = {
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
-}
-
-void writeSec(struct Frame* dateFrame, int inputSec)
-{
-	static const int numberOfValues = 3;
-	int value = inputSec;
-	int ones = value % 10;
-	value /= 10;
-	int tens = value % 10;
-	char dateValues[numberOfValues] = {
-		 tens + '0',
-		 ones + '0',
-		 '.'
-	};
-	writeLetters(dateValues, dateFrame, numberOfValues);
-	dateFrame->xStart += LETTER_WIDTH*(numberOfValues+1);
-	dateFrame->xEnd += LETTER_WIDTH*(numberOfValues+1);
+/* Seconds increment wakes the display for the clock, needs displayEvents */
+void rtcSecondInterruptSetup()
+{
+	LPC_RTC->AMR = 0xFF;  // no alarms
+	LPC_RTC->CIIR = 0x01;  // IMSEC
+	LPC_RTC->ILR = 0x01;
+	NVIC_SetPriority(RTC_IRQn, RTOS_IRQ_PRIORITY);
+	NVIC_EnableIRQ(RTC_IRQn);
+}
+
+void RTC_IRQHandler(void)
+{
+	LPC_RTC->ILR = 0x01;  // counter increment flag
+	osEventFlagsSet(displayEvents, DISPLAY_FLAG_CLOCK);
+}
+
+/* Writes value as width zero padded digits, returns position after them */
+char* formatNumber(char* letters, int value, int width)
+{
+	for(int digit = width - 1; digit >= 0; digit--)
+	{
+		letters[digit] = value % 10 + '0';
+		value /= 10;
+	}
+	return letters + width;
+}
+
+/* Writes value as width hex digits, returns position after them */
+char* formatHex(char* letters, uint32_t value, int width)
+{
+	for(int digit = width - 1; digit >= 0; digit--)
+	{
+		letters[digit] = "0123456789ABCDEF"[value & 0xF];
+		value >>= 4;
+	}
+	return letters + width;
+}
+
+/* YYYY.MM.DD.HH.MM.SS. */
+void formatDate(char* dateLetters, const struct Date* date)
+{
+	const int values[] = {date->year, date->month, date->day, date->hour, date->min, date->sec};
+	const int widths[] = {4, 2, 2, 2, 2, 2};
+	char* letter = dateLetters;
+	for(int field = 0; field < 6; field++)
+	{
+		letter = formatNumber(letter, values[field], widths[field]);
+		*letter++ = '.';
+	}
+}
+
+/* Reads the whole date from consolidated time registers,
+ * again when the time rolled over between the two reads */
+void readRtcDate(struct Date* date)
+{
+	uint32_t time;
+	uint32_t day;
+	do
+	{
+		time = LPC_RTC->CTIME0;
+		day = LPC_RTC->CTIME1;
+	} while(LPC_RTC->CTIME0 != time);
+	date->sec = time & 0x3F;
+	date->min = (time >> 8) & 0x3F;
+	date->hour = (time >> 16) & 0x1F;
+	date->day = day & 0x1F;
+	date->month = (day >> 8) & 0x0F;
+	date->year = (day >> 16) & 0x0FFF;
+}
+
+
+void writeDate(struct TextField* field, const struct Date* date)
+{
+	char dateLetters[DATE_TEXT_LEN];
+	formatDate(dateLetters, date);
+	updateTextField(field, dateLetters, DATE_TEXT_LEN);  // repaints only changed digits
 }
 
 void writeClockDate()
 {
-	struct Frame letterFrame = {10, 10 + LETTER_WIDTH, 280, 280 + LETTER_HEIGHT};
 	const char letters[12] = {'C','U','R','R','E','N','T',' ','D','A','T','E'};
-	writeLetters(letters, &letterFrame, 12);
-	struct Frame dateFrame = {10, 10 + LETTER_WIDTH, 300, 300 + LETTER_HEIGHT};
-	writeYear(&dateFrame, LPC_RTC->YEAR);
-	writeMonth(&dateFrame, LPC_RTC->MONTH);
-	writeDay(&dateFrame, LPC_RTC->DOY);
-	writeHour(&dateFrame, LPC_RTC->HOUR);
-	writeMinute(&dateFrame, LPC_RTC->MIN);
-	writeSec(&dateFrame, LPC_RTC->SEC);
+	updateTextField(&CLOCK_DATE_LABEL_FIELD, letters, 12);
+	struct Date clockDate;
+	readRtcDate(&clockDate);
+	writeDate(&CLOCK_DATE_FIELD, &clockDate);
 }
 
 void writeDateTypeToSeve(int dateInputCounter)
 {
 	int dateTypeIndex = dateInputCounter / 2;
-	static char lettersRow[7][4] = {{'Y','E','A','R'},
-																	{'Y','E','A','R'},
-																	{'M','O','N',' '},
-																	{'D','A','Y',' '},
-																	{'H','O','U','R'},
-																	{'M','I','N',' '},
-																	{'S','E','C',' '}};
+	static const char* const lettersRow[7] = {"YEAR", "YEAR", "MON ", "DAY ", "HOUR", "MIN ", "SEC "};
 	
-	struct Frame letterFrameCol = {70, 70 + LETTER_WIDTH, 70, 70 + LETTER_HEIGHT};
-	writeLetters(lettersRow[dateTypeIndex], &letterFrameCol, 4);
+	drawText(70, 70, lettersRow[dateTypeIndex]);
 }
 
+/* Prompt shows the field and the echo of the last key, the echo is replaced by the next key */
 bool saveDateValue(int* dateArray)
 {
 	static int dateInputCounter = 0;
-	static int lastSavedValue = -1;
-	int keyPressed = -1;
 	
 	writeDateTypeToSeve(dateInputCounter);
+	lcdCanvasFlush();
 	
 	struct Frame keyFrame = {100, 100+LETTER_WIDTH, 100, 100+LETTER_HEIGHT};
 	
-	do
-	{
-		keyPressed = keyboardScan();
-	} while (keyPressed == -1);
+	int keyPressed = waitForKeyPress();
 	
 	char symbol = KEYBOARD_MAP[keyPressed];
 	drawLetter(&keyFrame, symbol);
-	clearScreen();
 	
-	if(lastSavedValue != KEYPAD_VALUES[keyPressed])
+	dateArray[dateInputCounter] = KEYPAD_VALUES[keyPressed];
+	dateInputCounter += 1;
+
+	bool dateCollected = dateInputCounter >= 14;
+	if(dateCollected)
 	{
-		dateArray[dateInputCounter] = KEYPAD_VALUES[keyPressed];
-		dateInputCounter += 1;
-		lastSavedValue = KEYPAD_VALUES[keyPressed];
+		clearScreen();  // prompt is not part of the lock screen
 	}
-
-	return (dateInputCounter >= 14);
+	return dateCollected;
 }
 
 void getDate(int* dateArray)
@@ -543,7 +727,7 @@ void saveDate(int* dateArray)
 
 	int day = dateArray[arrIndex] * 10; arrIndex++;
 	day += dateArray[arrIndex]; arrIndex++;
-	LPC_RTC->DOY = day;
+	LPC_RTC->DOM = day;
 
 	int hour = dateArray[arrIndex] * 10; arrIndex++;
 	hour += dateArray[arrIndex]; arrIndex++;
@@ -563,46 +747,22 @@ void setDate()
 	int dateArray[14];
 	getDate(dateArray);
 	saveDate(dateArray);
-	osDelay(300);
-}
-
-void checkDButton()
-{
-	int keyPressed = keyboardScan();
-	if(keyPressed == 15)
-	{
-		LOCK_STATE = NEW_CODE;
-		resetPasscode();
-		osDelay(300);
-	}
 }
 
 
 void udpdateLastStateChangeDate()
 {
-	LAST_STATE_CHANGE.year = LPC_RTC->YEAR;
-	LAST_STATE_CHANGE.month = LPC_RTC->MONTH;
-	LAST_STATE_CHANGE.day = LPC_RTC->DOY;
-	LAST_STATE_CHANGE.hour = LPC_RTC->HOUR;
-	LAST_STATE_CHANGE.min = LPC_RTC->MIN;
-	LAST_STATE_CHANGE.sec = LPC_RTC->SEC;
+	readRtcDate(&LAST_STATE_CHANGE);
 }
 
-void writeLastStateChangeDate()
+void writeLastStateChangeDate(const struct LockSnapshot* snapshot)
 {
-	struct Frame letterFrame = {10, 10 + LETTER_WIDTH, 230, 230 + LETTER_HEIGHT};
 	const char letters[17] = {'L','A','S','T',' ','S','T','A','T','E',' ','C','H','A','N','G','E'};
-	writeLetters(letters, &letterFrame, 17);
-	struct Frame dateFrame = {10, 10 + LETTER_WIDTH, 250, 250 + LETTER_HEIGHT};
-	writeYear(&dateFrame, LAST_STATE_CHANGE.year);
-	writeMonth(&dateFrame, LAST_STATE_CHANGE.month);
-	writeDay(&dateFrame, LAST_STATE_CHANGE.day);
-	writeHour(&dateFrame, LAST_STATE_CHANGE.hour);
-	writeMinute(&dateFrame, LAST_STATE_CHANGE.min);
-	writeSec(&dateFrame, LAST_STATE_CHANGE.sec);
+	updateTextField(&LAST_STATE_CHANGE_LABEL_FIELD, letters, 17);
+	writeDate(&LAST_STATE_CHANGE_FIELD, &snapshot->lastStateChange);
 }
 
-void writeLastStateChange()
+void checkLastStateChange()
 {
 	static enum lock_state lasteKnownState = NEW_CODE;
 	if(LOCK_STATE != lasteKnownState)
@@ -610,8 +770,6 @@ void writeLastStateChange()
 		lasteKnownState = LOCK_STATE;
 		udpdateLastStateChangeDate();
 	}
-	
-	writeLastStateChangeDate();
 }
 
 void lightLed()
@@ -626,35 +784,389 @@ void lightLed()
 	}
 }
 
-void app_main (void *argument) {
-	clearScreen();
-	setDate();
+void publishSnapshot()
+{
+	struct LockSnapshot snapshot;
+	snapshot.state = LOCK_STATE;
+	const int* code = (LOCK_STATE == NEW_CODE) ? PASSCODE : ENTERED_CODE;
+	for(int digit = 0; digit < CODE_LEN; digit++)
+	{
+		snapshot.code[digit] = code[digit];
+	}
+	snapshot.keyEcho = KEY_ECHO;
+	snapshot.lastStateChange = LAST_STATE_CHANGE;
 
+	uint32_t dirty = 0;
+	osMutexAcquire(snapshotMutex, osWaitForever);
+	if(snapshot.keyEcho != LOCK_SNAPSHOT.keyEcho)
+	{
+		dirty |= DISPLAY_FLAG_KEY_ECHO;
+	}
+	if(snapshot.state != LOCK_SNAPSHOT.state || memcmp(snapshot.code, LOCK_SNAPSHOT.code, sizeof(snapshot.code)) != 0)
+	{
+		dirty |= DISPLAY_FLAG_CODE;  // code is hidden while unlocked
+	}
+	if(snapshot.state != LOCK_SNAPSHOT.state)
+	{
+		dirty |= DISPLAY_FLAG_LOCK_STATE;
+	}
+	if(memcmp(&snapshot.lastStateChange, &LOCK_SNAPSHOT.lastStateChange, sizeof(snapshot.lastStateChange)) != 0)
+	{
+		dirty |= DISPLAY_FLAG_LAST_CHANGE;
+	}
+	LOCK_SNAPSHOT = snapshot;
+	osMutexRelease(snapshotMutex);
+
+	if(dirty != 0)
+	{
+		osEventFlagsSet(displayEvents, dirty);
+	}
+}
+
+void readSnapshot(struct LockSnapshot* snapshot)
+{
+	osMutexAcquire(snapshotMutex, osWaitForever);
+	*snapshot = LOCK_SNAPSHOT;
+	osMutexRelease(snapshotMutex);
+}
+
+/* Owns lock state, woken by key events and relock timer */
+void logic_task (void *argument) {
 	while(1)
 	{
-		checkDButton();
-		writeKeypadInput();
-		writeEnteredCode();
-		writeLockState();
-		writeLastStateChange();
-		writeClockDate();
+		struct KeyEvent event;
+		bool keyActivity = false;
+		while(keypadGetEvent(&event))
+		{
+			handleKeyEvent(&event);
+			keyActivity = true;
+		}
+		if(keyActivity)
+		{
+			osEventFlagsSet(displayEvents, DISPLAY_FLAG_ACTIVITY);
+		}
+		checkLastStateChange();
 		lightLed();
-		osDelay(100);
-		clearScreen();
+		publishSnapshot();
+
+		uint32_t flags = osThreadFlagsWait(LOGIC_FLAG_KEY | LOGIC_FLAG_RELOCK, osFlagsWaitAny, osWaitForever);
+		if(!(flags & osFlagsError) && (flags & LOGIC_FLAG_RELOCK))
+		{
+			LOCK_STATE = LOCKED;
+		}
+	}
+}
+
+#if LCD_PROFILE
+bool framesOverlap(const struct Frame* frame, const struct Frame* other)
+{
+	return frame->xStart <= other->xEnd && other->xStart <= frame->xEnd
+		&& frame->yStart <= other->yEnd && other->yStart <= frame->yEnd;
+}
+
+/* Profile field at index, a letter wider on both sides, overlaps a screen field or an earlier profile field */
+bool profileFieldCovers(int fieldIdx)
+{
+	struct Frame frame;
+	textFieldFrame(&PROFILE_FIELDS[fieldIdx], &frame);
+	frame.xStart = frame.xStart > LETTER_ADVANCE ? frame.xStart - LETTER_ADVANCE : 0;  // a letter apart from its neighbours
+	frame.xEnd += LETTER_ADVANCE;
+	for(unsigned int screenIdx = 0; screenIdx < sizeof(SCREEN_FIELDS) / sizeof(SCREEN_FIELDS[0]); screenIdx++)
+	{
+		struct Frame screenFrame;
+		textFieldFrame(SCREEN_FIELDS[screenIdx], &screenFrame);
+		if(framesOverlap(&frame, &screenFrame))
+		{
+			return true;
+		}
+	}
+	for(int otherIdx = 0; otherIdx < fieldIdx; otherIdx++)
+	{
+		struct Frame otherFrame;
+		textFieldFrame(&PROFILE_FIELDS[otherIdx], &otherFrame);
+		if(framesOverlap(&frame, &otherFrame))
+		{
+			return true;
+		}
 	}
+	return false;
+}
+
+/* Each profile field goes to the first free spot in reading order, on the
+ * letter grid, so the layout follows the screen fields in every orientation */
+void layoutProfileFields()
+{
+	for(int fieldIdx = 0; fieldIdx <= PROFILE_VALUES; fieldIdx++)
+	{
+		struct TextField* field = &PROFILE_FIELDS[fieldIdx];
+		field->xPos = 0;
+		field->yPos = 0;
+		field->length = 0;
+		field->font = NULL;
+		field->scale = 1;
+		field->capacity = fieldIdx < PROFILE_VALUES ? PROFILE_VALUE_LEN : PROFILE_PC_LEN;
+		int width = field->capacity * LETTER_ADVANCE;
+		while(profileFieldCovers(fieldIdx) && field->yPos + LETTER_HEIGHT < LCD_MAX_Y)
+		{
+			field->xPos += LETTER_ADVANCE;
+			if(field->xPos + width > LCD_MAX_X)
+			{
+				field->xPos = 0;
+				field->yPos += LETTER_HEIGHT;
+			}
+		}
+	}
+}
+
+/* Frames of the screen fields, then of the profile fields as laid out, returns their count */
+int profileLayoutFrames(struct Frame* frames, int maxFrames)
+{
+	int count = 0;
+	for(unsigned int screenIdx = 0; screenIdx < sizeof(SCREEN_FIELDS) / sizeof(SCREEN_FIELDS[0]) && count < maxFrames; screenIdx++)
+	{
+		textFieldFrame(SCREEN_FIELDS[screenIdx], &frames[count++]);
+	}
+	for(int fieldIdx = 0; fieldIdx <= PROFILE_VALUES && count < maxFrames; fieldIdx++)
+	{
+		textFieldFrame(&PROFILE_FIELDS[fieldIdx], &frames[count++]);
+	}
+	return count;
+}
+
+/* XX 000000 */
+void writeProfileValue(struct TextField* field, const char* label, uint32_t value)
+{
+	char letters[PROFILE_VALUE_LEN];
+	letters[0] = label[0];
+	letters[1] = label[1];
+	letters[2] = ' ';
+	formatNumber(letters + 3, value, 6);
+	updateTextField(field, letters, PROFILE_VALUE_LEN);
+}
+
+/* Two values of a report line */
+void writeProfileLine(int line, const char* label1, uint32_t value1, const char* label2, uint32_t value2)
+{
+	writeProfileValue(&PROFILE_FIELDS[2 * line], label1, value1);
+	writeProfileValue(&PROFILE_FIELDS[2 * line + 1], label2, value2);
+}
+
+static uint32_t displayWakeups;
+static uint32_t displayBusCycles;
+
+/* Adds closed frame to the per second rates */
+void countDisplayFrame()
+{
+	const struct LcdProfileFrame* frame = lcdProfileLastFrame();
+	displayWakeups++;
+	// leaf sites only, register writes and cursor nest them
+	displayBusCycles += frame->site[LCD_PROFILE_WRITE_INDEX].cycles
+		+ frame->site[LCD_PROFILE_WRITE_DATA].cycles
+		+ frame->site[LCD_PROFILE_READ_DATA].cycles
+		+ frame->site[LCD_PROFILE_STREAM].cycles;
+}
+
+/* Tickless sleep residency of the last second [1/1000], run is the rest, sleep
+ * exit to key interrupt [cycles], key wake latency and panel wake to first frame [ms] */
+void writePowerReport()
+{
+	static struct LowPowerResidency lastResidency;
+	struct LowPowerResidency residency;
+	lowPowerGetResidency(&residency);
+	uint32_t cyclesPerMille = SystemCoreClock / 1000;
+	uint32_t sleep = (residency.sleepCycles - lastResidency.sleepCycles) / cyclesPerMille;
+	lastResidency = residency;
+	writeProfileLine(6, "SL", sleep, "SW", residency.wakeCycles);
+	writeProfileLine(7, "KL", keypadWakeLatency(), "WF", panelWakeToFrame);
+}
+
+/* PC 00000000, peripherals powered now */
+void writePeripheralReport()
+{
+	char letters[PROFILE_PC_LEN] = {'P', 'C', ' '};
+	formatHex(letters + 3, periphPowerEnabled(), 8);
+	updateTextField(&PROFILE_FIELDS[PROFILE_VALUES], letters, PROFILE_PC_LEN);
+}
+
+/* Bus cost of the previous frame and display rates of the last second,
+ * drawn once per second, the report itself is counted in the next frame */
+void writeProfileReport()
+{
+	static bool laidOut = false;
+	if(!laidOut)
+	{
+		layoutProfileFields();
+		laidOut = true;
+	}
+	const struct LcdProfileFrame* frame = lcdProfileLastFrame();
+	writeProfileLine(0, "IX", frame->site[LCD_PROFILE_WRITE_INDEX].calls,
+		"DT", frame->site[LCD_PROFILE_WRITE_DATA].calls);
+	writeProfileLine(1, "RG", frame->site[LCD_PROFILE_WRITE_REG].calls,
+		"CU", frame->site[LCD_PROFILE_SET_CURSOR].calls);
+	writeProfileLine(2, "ST", frame->site[LCD_PROFILE_STREAM].words,
+		"LA", frame->latches);
+	writeProfileLine(3, "SK", frame->site[LCD_PROFILE_STREAM].cycles / 1000,
+		"WK", frame->site[LCD_PROFILE_DELAY].cycles / 1000);
+	writeProfileLine(4, "WU", displayWakeups,
+		"BU", displayBusCycles / (SystemCoreClock / 1000000));  // bus time [us/s]
+	displayWakeups = 0;
+	displayBusCycles = 0;
+	writeProfileLine(5, "KS", keypadScanCycles(),
+		"DK", keypadDroppedEvents());
+	writePowerReport();
+	writePeripheralReport();
+}
+#endif
+
+/* Ticks until the panel steps down from mode */
+uint32_t panelTimeout(enum lcd_power_mode mode, uint32_t lastActivity)
+{
+	if(mode == LCD_POWER_STANDBY)
+	{
+		return osWaitForever;
+	}
+	uint32_t timeoutMs = (mode == LCD_POWER_FULL) ? PANEL_DIM_TIMEOUT_MS : PANEL_STANDBY_TIMEOUT_MS;
+	uint32_t deadline = lastActivity + timeoutMs * osKernelGetTickFreq() / 1000;
+	int32_t remaining = (int32_t)(deadline - osKernelGetTickCount());
+	return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+/* 8 color mode after PANEL_DIM_TIMEOUT_MS, then standby with clock updates stopped */
+enum lcd_power_mode panelStepDown(enum lcd_power_mode mode)
+{
+	if(mode == LCD_POWER_FULL)
+	{
+		lcdSetPowerMode(LCD_POWER_8_COLOR);
+		return LCD_POWER_8_COLOR;
+	}
+	LPC_RTC->CIIR = 0;  // no seconds wake-ups while nothing is shown
+	lcdSetPowerMode(LCD_POWER_STANDBY);
+	return LCD_POWER_STANDBY;
+}
+
+/* Back to full colors, GRAM and canvas are retained, so only regions changed meanwhile are drawn */
+uint32_t panelWake(enum lcd_power_mode mode)
+{
+	uint32_t pending = 0;
+	if(mode == LCD_POWER_STANDBY)
+	{
+		LPC_RTC->CIIR = 0x01;
+		pending = osEventFlagsClear(displayEvents, DISPLAY_FLAGS_ALL);
+		pending = (pending & osFlagsError) ? DISPLAY_FLAG_CLOCK : pending | DISPLAY_FLAG_CLOCK;
+	}
+	lcdSetPowerMode(LCD_POWER_FULL);
+	return pending;
+}
+
+/* Draws state snapshots, never touches lock state directly.
+ * Sleeps until a region is invalidated, then redraws only that region.
+ * Owns the panel, so it also steps panel power down on inactivity */
+void display_task (void *argument) {
+	enum lcd_power_mode panelMode = LCD_POWER_FULL;
+	uint32_t lastActivity = osKernelGetTickCount();
+	while(1)
+	{
+		uint32_t waitFlags = (panelMode == LCD_POWER_STANDBY) ? DISPLAY_FLAG_ACTIVITY : DISPLAY_FLAGS_ALL;
+		uint32_t dirty = osEventFlagsWait(displayEvents, waitFlags, osFlagsWaitAny, panelTimeout(panelMode, lastActivity));
+		if(dirty == osFlagsErrorTimeout || dirty == osFlagsErrorResource)
+		{
+			panelMode = panelStepDown(panelMode);
+			continue;
+		}
+		if(dirty & osFlagsError)
+		{
+			continue;
+		}
+		uint32_t wakeTick = 0;
+		bool panelWoken = false;
+		if(dirty & DISPLAY_FLAG_ACTIVITY)
+		{
+			lastActivity = osKernelGetTickCount();
+			if(panelMode != LCD_POWER_FULL)
+			{
+				wakeTick = lastActivity;
+				panelWoken = true;
+				dirty |= panelWake(panelMode);
+				panelMode = LCD_POWER_FULL;
+			}
+		}
+		struct LockSnapshot snapshot;
+		readSnapshot(&snapshot);
+		if(dirty & DISPLAY_FLAG_KEY_ECHO)
+		{
+			writeKeyEcho(&snapshot);
+		}
+		if(dirty & DISPLAY_FLAG_CODE)
+		{
+			writeEnteredCode(&snapshot);
+		}
+		if(dirty & DISPLAY_FLAG_LOCK_STATE)
+		{
+			writeLockState(&snapshot);
+		}
+		if(dirty & DISPLAY_FLAG_LAST_CHANGE)
+		{
+			writeLastStateChangeDate(&snapshot);
+		}
+		if(dirty & DISPLAY_FLAG_CLOCK)
+		{
+			writeClockDate();
+#if LCD_PROFILE
+			writeProfileReport();
+#endif
+		}
+		lcdCanvasFlush();
+		if(panelWoken)
+		{
+			panelWakeToFrame = (osKernelGetTickCount() - wakeTick) * 1000 / osKernelGetTickFreq();
+		}
+		lcdProfileEndFrame();
+#if LCD_PROFILE
+		countDisplayFrame();
+#endif
+	}
+}
+
+/* Startup: panel init and date entry, then hands over to logic and display tasks */
+void app_main (void *argument) {
+	static const osThreadAttr_t logicThreadAttr = {
+		.name = "logic",
+		.priority = osPriorityNormal
+	};
+	static const osThreadAttr_t displayThreadAttr = {
+		.name = "display",
+		.priority = osPriorityBelowNormal
+	};
+
+	init_ILI9325();  // panel power-up waits with osDelay
+	lcdCanvasInvalidate();  // GRAM is not cleared by reset
+	clearScreen();
+	keypadSetListener(osThreadGetId(), LOGIC_FLAG_KEY);  // date entry consumes keys until logic starts
+	setDate();
+	invalidateScreen();
+
+	logicThreadId = osThreadNew(logic_task, NULL, &logicThreadAttr);
+	keypadSetListener(logicThreadId, LOGIC_FLAG_KEY);
+	osThreadNew(display_task, NULL, &displayThreadAttr);
+	osEventFlagsSet(displayEvents, DISPLAY_FLAGS_ALL);  // first full frame
+	rtcSecondInterruptSetup();
+	osThreadExit();
 }
 
 int main()
 {
 	lcdConfiguration();
-	init_ILI9325();
 	gpioSetup();
 	configure_lpc_rtc();
 	osKernelInitialize();
+	snapshotMutex = osMutexNew(NULL);
+	displayEventsSetup();
+	relockTimerSetup();
+	keypadStart();
 	osThreadNew(app_main, NULL, NULL);
 
 	if (osKernelGetState() == osKernelReady){
     osKernelStart();                    								// Start thread execution
   }
 		
-}
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include "packedFont.h"
+
+#include <stddef.h>
+
+const uint8_t* packedFontGlyph(const struct PackedFont* font, char letter)
+{
+	uint8_t code = (uint8_t)letter;
+	if(code < font->firstChar || code > font->lastChar)
+	{
+		return NULL;
+	}
+	return font->runs + font->offsets[code - font->firstChar];
+}
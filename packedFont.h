@@ -0,0 +1,29 @@
+#ifndef __PACKED_FONT_H
+#define __PACKED_FONT_H
+
+#include <stdint.h>
+
+/* Run that continues with the same color, see tools/fontgen.py */
+#define PACKED_FONT_RUN_CONTINUE 15
+
+/* Run-length encoded glyphs, runs are 4 bit and alternate
+ * background and foreground starting with background */
+struct PackedFont{
+	uint8_t width;
+	uint8_t height;
+	uint8_t firstChar;
+	uint8_t lastChar;
+	const uint16_t* offsets;  // byte offset of each glyph in runs
+	const uint8_t* runs;
+};
+
+/* 2x EPX upscaled MS Gothic digits, for code entry */
+extern const struct PackedFont FONT_DIGITS_16X32;
+
+/*****************************
+ *  Runs of glyph, high nibble first,
+ *  NULL for characters not in font
+ */
+const uint8_t* packedFontGlyph(const struct PackedFont* font, char letter);
+
+#endif
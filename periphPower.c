@@ -0,0 +1,87 @@
+#include "periphPower.h"
+#include <LPC17xx.h>
+
+#define PERIPH_PCLK_NONE 0xFF
+
+struct PeriphPowerBlock{
+	uint8_t pconpBit;
+	uint8_t pclkBit;  // of PCLKSEL0, PCLKSEL1 from 32, PERIPH_PCLK_NONE without divider
+	uint8_t pclkDiv;  // enum periph_pclk_div
+};
+
+/* Dividers are per block, lower PCLK where the block does not need speed.
+ * All are set once by periphPowerClockSetup, PCLKSEL may not change after PLL0 is connected */
+static const struct PeriphPowerBlock PERIPH_BLOCKS[PERIPH_POWER_BLOCKS] = {
+	[PERIPH_POWER_TIMER0] = { 1,  2, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_TIMER1] = { 2,  4, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_TIMER2] = {22, 44, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_TIMER3] = {23, 46, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_UART0]  = { 3,  6, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_UART1]  = { 4,  8, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_UART2]  = {24, 48, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_UART3]  = {25, 50, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_PWM1]   = { 6, 12, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_I2C0]   = { 7, 14, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_I2C1]   = {19, 38, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_I2C2]   = {26, 52, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_SPI]    = { 8, 16, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_SSP0]   = {21, 42, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_SSP1]   = {10, 20, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_RTC]    = { 9, PERIPH_PCLK_NONE, 0},  // counts from its 32 kHz oscillator
+	[PERIPH_POWER_ADC]    = {12, 24, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_CAN1]   = {13, 26, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_CAN2]   = {14, 28, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_GPIO]   = {15, 34, PERIPH_PCLK_DIV_8},  // only edge detection of keypad columns
+	[PERIPH_POWER_RIT]    = {16, 58, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_MCPWM]  = {17, 62, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_QEI]    = {18, 32, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_I2S]    = {27, 54, PERIPH_PCLK_DIV_4},
+	[PERIPH_POWER_GPDMA]  = {29, PERIPH_PCLK_NONE, 0},
+	[PERIPH_POWER_ENET]   = {30, PERIPH_PCLK_NONE, 0},
+	[PERIPH_POWER_USB]    = {31, PERIPH_PCLK_NONE, 0}
+};
+
+static uint8_t references[PERIPH_POWER_BLOCKS];
+
+/* Only constant data, it runs from SystemInit before RAM is initialized */
+void periphPowerClockSetup()
+{
+	uint32_t pclksel[2] = {0, 0};
+	for(int block = 0; block < PERIPH_POWER_BLOCKS; block++)
+	{
+		uint8_t pclkBit = PERIPH_BLOCKS[block].pclkBit;
+		if(pclkBit != PERIPH_PCLK_NONE)
+		{
+			pclksel[pclkBit / 32] |= (uint32_t)PERIPH_BLOCKS[block].pclkDiv << (pclkBit % 32);
+		}
+	}
+	LPC_SC->PCLKSEL0 = pclksel[0];
+	LPC_SC->PCLKSEL1 = pclksel[1];
+}
+
+void periphPowerAcquire(enum periph_power_block block)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(references[block]++ == 0)
+	{
+		LPC_SC->PCONP |= 1U << PERIPH_BLOCKS[block].pconpBit;
+	}
+	__set_PRIMASK(primask);
+}
+
+void periphPowerRelease(enum periph_power_block block)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(references[block] > 0 && --references[block] == 0)
+	{
+		LPC_SC->PCONP &= ~(1U << PERIPH_BLOCKS[block].pconpBit);
+	}
+	__set_PRIMASK(primask);
+}
+
+uint32_t periphPowerEnabled()
+{
+	return LPC_SC->PCONP;
+}
@@ -0,0 +1,69 @@
+#ifndef __PERIPH_POWER_H
+#define __PERIPH_POWER_H
+
+#include <stdint.h>
+
+/* Blocks with a PCONP bit, system_LPC17xx.c leaves all of them off */
+enum periph_power_block{
+	PERIPH_POWER_TIMER0,
+	PERIPH_POWER_TIMER1,
+	PERIPH_POWER_TIMER2,
+	PERIPH_POWER_TIMER3,
+	PERIPH_POWER_UART0,
+	PERIPH_POWER_UART1,
+	PERIPH_POWER_UART2,
+	PERIPH_POWER_UART3,
+	PERIPH_POWER_PWM1,
+	PERIPH_POWER_I2C0,
+	PERIPH_POWER_I2C1,
+	PERIPH_POWER_I2C2,
+	PERIPH_POWER_SPI,
+	PERIPH_POWER_SSP0,
+	PERIPH_POWER_SSP1,
+	PERIPH_POWER_RTC,
+	PERIPH_POWER_ADC,
+	PERIPH_POWER_CAN1,
+	PERIPH_POWER_CAN2,
+	PERIPH_POWER_GPIO,   // PCLK is for GPIO interrupts
+	PERIPH_POWER_RIT,
+	PERIPH_POWER_MCPWM,
+	PERIPH_POWER_QEI,
+	PERIPH_POWER_I2S,
+	PERIPH_POWER_GPDMA,
+	PERIPH_POWER_ENET,
+	PERIPH_POWER_USB,
+	PERIPH_POWER_BLOCKS
+};
+
+/* PCLKSEL field values */
+enum periph_pclk_div{
+	PERIPH_PCLK_DIV_4 = 0,
+	PERIPH_PCLK_DIV_1 = 1,
+	PERIPH_PCLK_DIV_2 = 2,
+	PERIPH_PCLK_DIV_8 = 3
+};
+
+/*****************************
+ *  PCLKSEL0 and PCLKSEL1 of all blocks,
+ *  called by SystemInit before PLL0 is
+ *  connected, as the LPC1768 errata requires
+ */
+void periphPowerClockSetup(void);
+
+/*****************************
+ *  Powers the block on first reference,
+ *  its PCLK divider was set by SystemInit
+ */
+void periphPowerAcquire(enum periph_power_block block);
+
+/*****************************
+ *  Powers the block off with last reference
+ */
+void periphPowerRelease(enum periph_power_block block);
+
+/*****************************
+ *  Enabled set, PCONP bits
+ */
+uint32_t periphPowerEnabled(void);
+
+#endif
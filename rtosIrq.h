@@ -0,0 +1,11 @@
+#ifndef __RTOS_IRQ_H
+#define __RTOS_IRQ_H
+
+#include <LPC17xx.h>
+#include "FreeRTOS.h"
+
+/* NVIC priority of interrupts whose handlers call the RTOS, the most
+ * urgent one configMAX_SYSCALL_INTERRUPT_PRIORITY allows */
+#define RTOS_IRQ_PRIORITY (configMAX_SYSCALL_INTERRUPT_PRIORITY >> (8 - __NVIC_PRIO_BITS))
+
+#endif
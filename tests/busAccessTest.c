@@ -0,0 +1,85 @@
+/* GPIO accesses per GRAM word: lcdWriteData sets up the bus for every
+ * word, a stream only latches and strobes, a fill only strobes.
+ * A read-modify-write of a register counts as one access */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+
+#include <stdio.h>
+
+#define WORDS 1000
+
+static uint32_t perWord(const char* name, const struct HostLcdCounters* counters)
+{
+	printf("%-16s %2u.%02u GPIO accesses %3u cycles per word\n", name,
+		counters->gpioAccesses / WORDS, counters->gpioAccesses % WORDS / 10,
+		(uint32_t)(counters->cycles / WORDS));
+	CHECK(counters->gramWrites == WORDS);
+	CHECK(counters->timingErrors == 0 && counters->busErrors == 0);
+	return counters->gpioAccesses;
+}
+
+static bool rowHolds(uint16_t y, uint16_t value)
+{
+	for(int x = 0; x < LCD_MAX_X; x++)
+	{
+		if(hostLcdScreenPixel(x, y) != value)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	struct HostLcdCounters before;
+
+	lcdSetWindow(0, LCD_MAX_X - 1, 0, LCD_MAX_Y - 1);
+	lcdWriteIndex(DATA_RAM);
+	hostLcdCounters(&before);
+	for(int n = 0; n < WORDS; n++)
+	{
+		lcdWriteData(n & 1 ? LCDBlue : LCDRed);
+	}
+	struct HostLcdCounters data = hostLcdSince(&before);
+	uint32_t dataAccesses = perWord("lcdWriteData", &data);
+
+	lcdSetWindow(0, LCD_MAX_X - 1, 10, LCD_MAX_Y - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	hostLcdCounters(&before);
+	for(int n = 0; n < WORDS; n++)
+	{
+		lcdStreamData(n & 1 ? LCDBlue : LCDRed);
+	}
+	struct HostLcdCounters stream = hostLcdSince(&before);
+	lcdEndDataStream();
+	uint32_t streamAccesses = perWord("lcdStreamData", &stream);
+
+	lcdSetWindow(0, LCD_MAX_X - 1, 20, LCD_MAX_Y - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	hostLcdCounters(&before);
+	lcdStreamFill(LCDGreen, WORDS);
+	struct HostLcdCounters fill = hostLcdSince(&before);
+	lcdEndDataStream();
+	uint32_t fillAccesses = perWord("lcdStreamFill", &fill);
+
+	// 2 byte writes, LE pulse and WR pulse, no direction, CS or RS setup
+	CHECK(streamAccesses == 6 * WORDS);
+	// WR pulse only, the latch is loaded once
+	CHECK(fillAccesses <= 2 * WORDS + 5);
+	CHECK(streamAccesses * 2 <= dataAccesses);
+	CHECK(data.latches == WORDS && stream.latches == WORDS && fill.latches == 1);
+
+	CHECK(hostLcdScreenPixel(0, 0) == LCDRed && hostLcdScreenPixel(1, 0) == LCDBlue);
+	CHECK(hostLcdScreenPixel(0, 10) == LCDRed && hostLcdScreenPixel(1, 10) == LCDBlue);
+	CHECK(rowHolds(20, LCDGreen));
+	return hostTestResult();
+}
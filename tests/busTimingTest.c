@@ -0,0 +1,91 @@
+/* Bus timings in core cycles for PLL0 and CPU clock settings, and the
+ * model's timing check of a register and GRAM burst at each clock */
+
+#include "hostDevice.h"
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+
+#include <stdio.h>
+
+struct ClockSetting{
+	uint32_t pll0con;
+	uint32_t pll0cfg;
+	uint32_t cclkcfg;
+	uint32_t coreClock;
+	uint32_t writeLow;    // LCD_T_WRL_NS, also LCD_T_WRH_NS
+	uint32_t readAccess;  // LCD_T_RDL_NS
+	uint32_t buffer;      // LCD_T_BUF_NS
+	uint32_t hold;        // LCD_T_DHW_NS
+};
+
+static const struct ClockSetting CLOCKS[] = {
+	{0x03, 0x00050063, 0x03, 100000000, 5, 17, 3, 2},  // M 100, N 6, /4, system_LPC17xx.c
+	{0x03, 0x0000000B, 0x03,  72000000, 4, 13, 3, 2},  // M 12, N 1, /4
+	{0x00, 0x00000000, 0x00,  12000000, 1,  3, 1, 1},  // PLL0 bypassed, main oscillator
+};
+
+/* Cycles last at least ns, one cycle less would be too short */
+static bool roundsUp(uint32_t ns, uint32_t clock)
+{
+	uint32_t cycles = lcdNsToCycles(ns, clock);
+	return (uint64_t)cycles * 1000000000 >= (uint64_t)ns * clock
+		&& (cycles == 0 || (uint64_t)(cycles - 1) * 1000000000 < (uint64_t)ns * clock);
+}
+
+int main(int argc, char** argv)
+{
+	for(unsigned int clockIdx = 0; clockIdx < sizeof(CLOCKS) / sizeof(CLOCKS[0]); clockIdx++)
+	{
+		const struct ClockSetting* setting = &CLOCKS[clockIdx];
+		hostSc.PLL0CON = setting->pll0con;
+		hostSc.PLL0CFG = setting->pll0cfg;
+		hostSc.CCLKCFG = setting->cclkcfg;
+		hostLcdReset();
+		lcdConfiguration();  // lcdTimingInit reads the clock setup again
+		CHECK(SystemCoreClock == setting->coreClock);
+		CHECK(lcdNsToCycles(LCD_T_WRL_NS, SystemCoreClock) == setting->writeLow);
+		CHECK(lcdNsToCycles(LCD_T_WRH_NS, SystemCoreClock) == setting->writeLow);
+		CHECK(lcdNsToCycles(LCD_T_RDL_NS, SystemCoreClock) == setting->readAccess);
+		CHECK(lcdNsToCycles(LCD_T_BUF_NS, SystemCoreClock) == setting->buffer);
+		CHECK(lcdNsToCycles(LCD_T_DHW_NS, SystemCoreClock) == setting->hold);
+
+		struct HostLcdCounters before;
+		hostLcdCounters(&before);
+		lcdWriteReg(ENTRYM, LCD_ENTRY_MODE);
+		lcdSetWindow(0, 15, 0, 15);
+		lcdWriteIndex(DATA_RAM);
+		lcdBeginDataStream();
+		for(int n = 0; n < 16; n++)
+		{
+			lcdStreamData(n);
+		}
+		lcdStreamFill(LCDRed, 240);
+		lcdEndDataStream();
+		CHECK(lcdReadReg(0x0000) == 0x9325);
+		struct HostLcdCounters bus = hostLcdSince(&before);
+		printf("%3u MHz: %u bus writes, %u timing errors\n", SystemCoreClock / 1000000,
+			bus.indexWrites + bus.registerWrites + bus.gramWrites, bus.timingErrors);
+		CHECK(bus.gramWrites == 256);
+		CHECK(bus.timingErrors == 0 && bus.busErrors == 0);
+		CHECK(hostLcdScreenPixel(15, 0) == 15 && hostLcdScreenPixel(0, 15) == LCDRed);
+	}
+
+	// rounding up, also where the clock is not whole MHz
+	CHECK(lcdNsToCycles(0, 100000000) == 0);
+	CHECK(lcdNsToCycles(10, 100000000) == 1);
+	CHECK(lcdNsToCycles(11, 100000000) == 2);
+	CHECK(lcdNsToCycles(83, 12000000) == 1);  // 0.996 cycles
+	CHECK(lcdNsToCycles(84, 12000000) == 2);  // 1.008 cycles
+	const uint32_t oddClocks[] = {52800000, 99999999, 1000001, 4000000};
+	const uint32_t times[] = {1, 5, 15, 30, 50, 170, 1000, 100000};
+	for(unsigned int clockIdx = 0; clockIdx < sizeof(oddClocks) / sizeof(oddClocks[0]); clockIdx++)
+	{
+		for(unsigned int timeIdx = 0; timeIdx < sizeof(times) / sizeof(times[0]); timeIdx++)
+		{
+			CHECK(roundsUp(times[timeIdx], oddClocks[clockIdx]));
+		}
+	}
+	return hostTestResult();
+}
@@ -0,0 +1,89 @@
+/* Random windowed fills on the canvas, after every flush the GRAM has
+ * to hold the same picture as a plain reference bitmap */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+
+#include <stdio.h>
+
+#define ROUNDS 40
+#define FILLS_PER_ROUND 8
+
+static bool reference[LCD_MAX_Y][LCD_MAX_X];
+static uint32_t seed = 12345;
+
+static uint32_t randomBelow(uint32_t limit)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % limit;
+}
+
+/* Same fill order as GRAM: row by row inside the window, nothing past its end */
+static void fillReference(uint16_t xStart, uint16_t xEnd, uint16_t yStart, uint16_t yEnd, bool set, uint32_t count)
+{
+	for(uint16_t y = yStart; y <= yEnd && count > 0; y++)
+	{
+		for(uint16_t x = xStart; x <= xEnd && count > 0; x++, count--)
+		{
+			reference[y][x] = set;
+		}
+	}
+}
+
+static int gramMismatches(void)
+{
+	int mismatches = 0;
+	for(int y = 0; y < LCD_MAX_Y; y++)
+	{
+		for(int x = 0; x < LCD_MAX_X; x++)
+		{
+			if(hostLcdScreenPixel(x, y) != (reference[y][x] ? LCDBlack : LCDWhite))
+			{
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	lcdCanvasSetPalette(LCDWhite, LCDBlack);
+
+	// GRAM holds a power-on pattern, the first flush pushes every tile
+	lcdCanvasOpenWindow(0, LCD_MAX_X - 1, 0, LCD_MAX_Y - 1);
+	lcdCanvasStreamFill(LCDWhite, (uint32_t)LCD_MAX_X * LCD_MAX_Y);
+	CHECK(lcdCanvasFlush() == (LCD_MAX_X / LCD_CANVAS_TILE) * (LCD_MAX_Y / LCD_CANVAS_TILE));
+	CHECK(gramMismatches() == 0);
+
+	uint32_t pushed = 0;
+	for(int round = 0; round < ROUNDS; round++)
+	{
+		for(int fill = 0; fill < FILLS_PER_ROUND; fill++)
+		{
+			uint16_t xStart = randomBelow(LCD_MAX_X), yStart = randomBelow(LCD_MAX_Y);
+			uint16_t xEnd = xStart + randomBelow(LCD_MAX_X - xStart), yEnd = yStart + randomBelow(LCD_MAX_Y - yStart);
+			uint32_t area = (uint32_t)(xEnd - xStart + 1) * (yEnd - yStart + 1);
+			uint32_t count = randomBelow(area + area / 4) + 1;  // partial fills and fills past the window
+			bool set = randomBelow(2);
+			lcdCanvasOpenWindow(xStart, xEnd, yStart, yEnd);
+			lcdCanvasStreamFill(set ? LCDBlack : LCDWhite, count);
+			fillReference(xStart, xEnd, yStart, yEnd, set, count);
+		}
+		pushed += lcdCanvasFlush();
+		if(!CHECK(gramMismatches() == 0))
+		{
+			fprintf(stderr, "round %d: %d pixels differ\n", round, gramMismatches());
+			break;
+		}
+		CHECK(lcdCanvasFlush() == 0);  // nothing changed since
+	}
+	printf("%d rounds, %u tiles pushed\n", ROUNDS, pushed);
+	return hostTestResult();
+}
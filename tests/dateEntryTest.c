@@ -0,0 +1,90 @@
+/* Date entry, one key at a time: the prompt names the field and shows
+ * the last key typed, the screen is blank once the date is complete */
+
+#include "hostLcd.h"
+#include "hostKeypad.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+#include "asciiLib.h"
+
+#include <stdio.h>
+
+#define DATE_DIGITS 14
+#define LABEL_X 70
+#define LABEL_Y 70
+#define ECHO_X 100
+#define ECHO_Y 100
+
+/* Key index of digit, KEYBOARD_MAP of main.c */
+static const uint8_t DIGIT_KEYS[10] = {12, 0, 1, 2, 4, 5, 6, 8, 9, 10};
+/* 2025.01.02 03:04:05 */
+static const int DATE[DATE_DIGITS] = {2, 0, 2, 5, 0, 1, 0, 2, 0, 3, 0, 4, 0, 5};
+/* First letter of the field label, YEAR MON DAY HOUR MIN SEC */
+static const char LABELS[DATE_DIGITS / 2] = {'Y', 'Y', 'M', 'D', 'H', 'M', 'S'};
+
+static int dateArray[DATE_DIGITS];
+
+static void dateEntryTask(void* argument)
+{
+	while(!saveDateValue(dateArray));
+	osThreadExit();
+}
+
+static bool glyphAt(uint16_t x, uint16_t y, char letter)
+{
+	const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letter);
+	for(int row = 0; row < ASCII_GLYPH_HEIGHT; row++)
+	{
+		for(int col = 0; col < ASCII_GLYPH_WIDTH; col++)
+		{
+			uint16_t expected = (glyph[row] >> (ASCII_GLYPH_WIDTH - 1 - col)) & 1 ? LCDBlack : LCDWhite;
+			if(hostLcdScreenPixel(x + col, y + row) != expected)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	lcdCanvasInvalidate();
+	clearScreen();
+
+	hostRtosRun(dateEntryTask, NULL);
+	CHECK(glyphAt(LABEL_X, LABEL_Y, 'Y'));
+	CHECK(glyphAt(ECHO_X, ECHO_Y, ' '));  // nothing typed yet
+
+	for(int digit = 0; digit < DATE_DIGITS; digit++)
+	{
+		hostKeypadPress(DIGIT_KEYS[DATE[digit]]);
+		hostRtosRun(dateEntryTask, NULL);
+		if(digit + 1 == DATE_DIGITS)
+		{
+			break;
+		}
+		bool shown = CHECK(glyphAt(ECHO_X, ECHO_Y, '0' + DATE[digit]));
+		shown &= CHECK(glyphAt(LABEL_X, LABEL_Y, LABELS[(digit + 1) / 2]));
+		if(!shown)
+		{
+			fprintf(stderr, "prompt after digit %d\n", digit);
+		}
+	}
+
+	// complete date, the display task flushes the cleared canvas
+	lcdCanvasFlush();
+	CHECK(glyphAt(LABEL_X, LABEL_Y, ' '));
+	CHECK(glyphAt(ECHO_X, ECHO_Y, ' '));
+	for(int digit = 0; digit < DATE_DIGITS; digit++)
+	{
+		CHECK(dateArray[digit] == DATE[digit]);
+	}
+	return hostTestResult();
+}
@@ -0,0 +1,83 @@
+/* Panel bring-up and drawing against the register-trace ILI9325 model */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+#include "asciiLib.h"
+
+#include <stdio.h>
+
+static bool screenIs(uint16_t color)
+{
+	for(int y = 0; y < LCD_MAX_Y; y++)
+	{
+		for(int x = 0; x < LCD_MAX_X; x++)
+		{
+			if(hostLcdScreenPixel(x, y) != color)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* Glyph of asciiLib with its top left corner at x, y, gap columns background */
+static bool glyphAt(uint16_t x, uint16_t y, char letter)
+{
+	const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letter);
+	for(int row = 0; row < ASCII_GLYPH_HEIGHT; row++)
+	{
+		for(int col = 0; col < ASCII_GLYPH_WIDTH; col++)
+		{
+			uint16_t expected = (glyph[row] >> (ASCII_GLYPH_WIDTH - 1 - col)) & 1 ? LCDBlack : LCDWhite;
+			if(hostLcdScreenPixel(x + col, y + row) != expected)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+
+	CHECK(hostLcdRegister(ENTRYM) == LCD_ENTRY_MODE);
+	CHECK(hostLcdRegister(HADRPOS_RAM_END) == LCD_GRAM_WIDTH - 1);
+	CHECK(hostLcdRegister(VADRPOS_RAM_END) == LCD_GRAM_HEIGHT - 1);
+	CHECK(lcdReadReg(0x0000) == 0x9325);
+
+	// reset leaves GRAM as it was, the first flush has to cover all of it
+	CHECK(!screenIs(LCDWhite));
+	lcdCanvasInvalidate();
+	clearScreen();
+	lcdCanvasFlush();
+	CHECK(screenIs(LCDWhite));
+
+	drawText(10, 20, "Ag1#");
+	lcdCanvasFlush();
+	CHECK(glyphAt(10, 20, 'A'));
+	CHECK(glyphAt(20, 20, 'g'));
+	CHECK(glyphAt(30, 20, '1'));
+	CHECK(glyphAt(40, 20, '#'));
+
+	struct HostLcdCounters counters;
+	hostLcdCounters(&counters);
+	CHECK(counters.timingErrors == 0);
+	CHECK(counters.busErrors == 0);
+
+	if(argc > 1)
+	{
+		char path[256];
+		snprintf(path, sizeof(path), "%s/emulator.ppm", argv[1]);
+		CHECK(hostLcdWritePpm(path));
+	}
+	return hostTestResult();
+}
@@ -0,0 +1,70 @@
+/* Time of a full screen fill against the WR cycle limit of the panel.
+ * Built once more with LCD_PROFILE=1: the WR waits are inline, so a
+ * profiled build adds no profiled delay per pixel */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+#include "lcdProfile.h"
+
+#include <stdio.h>
+
+#define SCREEN_WORDS ((uint32_t)LCD_MAX_X * LCD_MAX_Y)
+
+static uint32_t delayCalls(void)
+{
+#if LCD_PROFILE
+	return lcdProfileCurrent.site[LCD_PROFILE_DELAY].calls;
+#else
+	return 0;
+#endif
+}
+
+static uint32_t cyclesToUs(uint64_t cycles)
+{
+	return (uint32_t)(cycles * 1000000 / SystemCoreClock);
+}
+
+static void report(const char* name, const struct HostLcdCounters* counters, uint32_t delays)
+{
+	printf("%-12s %6u us, %2u cycles per word, %u profiled delays\n", name,
+		cyclesToUs(counters->cycles), (uint32_t)(counters->cycles / SCREEN_WORDS), delays);
+	CHECK(counters->gramWrites == SCREEN_WORDS);
+	CHECK(counters->timingErrors == 0 && counters->busErrors == 0);
+	CHECK(delays == 0);
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	uint32_t panelLimitUs = (uint32_t)((uint64_t)SCREEN_WORDS * (LCD_T_WRL_NS + LCD_T_WRH_NS) / 1000);
+	printf("panel limit  %6u us, %u MHz core\n", panelLimitUs, (unsigned)(SystemCoreClock / 1000000));
+	struct HostLcdCounters before;
+
+	lcdSetWindow(0, LCD_MAX_X - 1, 0, LCD_MAX_Y - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	uint32_t delays = delayCalls();
+	hostLcdCounters(&before);
+	lcdStreamFill(LCDBlue, SCREEN_WORDS);
+	struct HostLcdCounters fill = hostLcdSince(&before);
+	lcdEndDataStream();
+	report("stream fill", &fill, delayCalls() - delays);
+	CHECK(cyclesToUs(fill.cycles) >= panelLimitUs);
+
+	// clearScreen of the firmware, pushed by the canvas
+	lcdCanvasInvalidate();
+	clearScreen();
+	delays = delayCalls();
+	hostLcdCounters(&before);
+	lcdCanvasFlush();
+	struct HostLcdCounters flush = hostLcdSince(&before);
+	report("clearScreen", &flush, delayCalls() - delays);
+	CHECK(hostLcdScreenPixel(0, 0) == LCDWhite && hostLcdScreenPixel(LCD_MAX_X - 1, LCD_MAX_Y - 1) == LCDWhite);
+	return hostTestResult();
+}
@@ -0,0 +1,83 @@
+/* Bus writes of a display frame: the full repaint every frame used to
+ * do against the retained screen that repaints changed glyph cells */
+
+#include "hostDevice.h"
+#include "hostLcd.h"
+#include "hostKeypad.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "FreeRTOS.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+
+#include <stdio.h>
+
+static void setRtcTime(int hour, int min, int sec)
+{
+	hostRtcSetTime((hour << 16) | (min << 8) | sec, (2024 << 16) | (5 << 8) | 17);
+}
+
+/* One pass of the display task, up to where it sleeps again */
+static struct HostLcdCounters displayFrame(const char* name)
+{
+	struct HostLcdCounters before;
+	hostLcdCounters(&before);
+	hostRtosRun(display_task, NULL);
+	struct HostLcdCounters frame = hostLcdSince(&before);
+	printf("%-10s %6u GRAM writes %4u index writes %4u register writes %7u GPIO accesses\n",
+		name, frame.gramWrites, frame.indexWrites, frame.registerWrites, frame.gpioAccesses);
+	return frame;
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	configure_lpc_rtc();
+	displayEventsSetup();
+	rtcSecondInterruptSetup();
+	// the seconds handler sets display events, so it may not preempt the kernel
+	CHECK((hostNvicPriority[RTC_IRQn] << (8 - __NVIC_PRIO_BITS)) >= configMAX_SYSCALL_INTERRUPT_PRIORITY);
+	setRtcTime(12, 34, 56);
+	hostRtosRun(logic_task, NULL);  // first snapshot, with the last state change date
+
+	// every frame of the old loop: clear, then draw every field again
+	lcdCanvasInvalidate();
+	clearScreen();
+	invalidateScreen();
+	osEventFlagsSet(displayEvents, FIRMWARE_DISPLAY_FLAGS_ALL);
+	struct HostLcdCounters full = displayFrame("full");
+	CHECK(full.gramWrites >= LCD_MAX_X * LCD_MAX_Y);
+
+	// the clock advanced one second, only the seconds digits are drawn
+	setRtcTime(12, 34, 57);
+	RTC_IRQHandler();
+	struct HostLcdCounters second = displayFrame("second");
+	CHECK(second.gramWrites > 0);
+	CHECK(second.gramWrites <= 4 * LCD_CANVAS_TILE * LCD_CANVAS_TILE);  // 2 glyphs, at most 4 tiles
+	CHECK(second.gpioAccesses * 50 < full.gpioAccesses);
+
+	// nothing changed, nothing is sent
+	RTC_IRQHandler();
+	struct HostLcdCounters idle = displayFrame("unchanged");
+	CHECK(idle.gramWrites == 0);
+	CHECK(idle.indexWrites == 0);
+
+	// a key pressed and released, the code gets its first digit
+	hostKeypadPress(0);
+	hostRtosRun(logic_task, NULL);
+	struct HostLcdCounters key = displayFrame("key");
+	CHECK(key.gramWrites > 0);
+	CHECK(key.gpioAccesses * 50 < full.gpioAccesses);
+
+	CHECK(hostLcdSince(&(struct HostLcdCounters){0}).timingErrors == 0);
+	if(argc > 1)
+	{
+		char path[256];
+		snprintf(path, sizeof(path), "%s/frameBus.ppm", argv[1]);
+		CHECK(hostLcdWritePpm(path));
+	}
+	return hostTestResult();
+}
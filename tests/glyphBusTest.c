@@ -0,0 +1,112 @@
+/* Bus cost per glyph: three register writes per foreground pixel,
+ * as drawLetter used to draw, against windowed bursts of the canvas */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+#include "asciiLib.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEXT "SAFELOCK 2024.05.17"
+
+static void pixelLetter(uint16_t x, uint16_t y, char letter)
+{
+	const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letter);
+	for(int row = 0; row < ASCII_GLYPH_HEIGHT; row++)
+	{
+		for(int col = 0; col < ASCII_GLYPH_WIDTH; col++)
+		{
+			if((glyph[row] >> (ASCII_GLYPH_WIDTH - 1 - col)) & 1)
+			{
+				lcdWriteReg(ADRX_RAM, x + col);
+				lcdWriteReg(ADRY_RAM, y + row);
+				lcdWriteReg(DATA_RAM, LCDBlack);
+			}
+		}
+	}
+}
+
+/* One window and one burst of all 128 pixels, what the canvas flush does per tile */
+static void burstLetter(uint16_t x, uint16_t y, char letter)
+{
+	const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, letter);
+	lcdSetWindow(x, x + ASCII_GLYPH_WIDTH - 1, y, y + ASCII_GLYPH_HEIGHT - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	for(int row = 0; row < ASCII_GLYPH_HEIGHT; row++)
+	{
+		for(int col = 0; col < ASCII_GLYPH_WIDTH; col++)
+		{
+			lcdStreamData((glyph[row] >> (ASCII_GLYPH_WIDTH - 1 - col)) & 1 ? LCDBlack : LCDWhite);
+		}
+	}
+	lcdEndDataStream();
+}
+
+static void report(const char* name, const struct HostLcdCounters* counters, int glyphs)
+{
+	printf("%-12s per glyph: %5u bus writes %5u GPIO accesses %6u cycles\n", name,
+		(counters->indexWrites + counters->registerWrites + counters->gramWrites) / glyphs,
+		counters->gpioAccesses / glyphs, (uint32_t)(counters->cycles / glyphs));
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	lcdCanvasInvalidate();
+	clearScreen();
+	lcdCanvasFlush();
+	int glyphs = strlen(TEXT);
+
+	struct HostLcdCounters before;
+	hostLcdCounters(&before);
+	for(int letterIdx = 0; letterIdx < glyphs; letterIdx++)
+	{
+		pixelLetter(10 + letterIdx * 10, 100, TEXT[letterIdx]);
+	}
+	struct HostLcdCounters pixels = hostLcdSince(&before);
+	report("per pixel", &pixels, glyphs);
+
+	hostLcdCounters(&before);
+	for(int letterIdx = 0; letterIdx < glyphs; letterIdx++)
+	{
+		burstLetter(10 + letterIdx * 10, 200, TEXT[letterIdx]);
+	}
+	struct HostLcdCounters burst = hostLcdSince(&before);
+	report("burst", &burst, glyphs);
+
+	hostLcdCounters(&before);
+	drawText(10, 160, TEXT);  // tile row of its own, flushed tiles cover all 16 rows
+	lcdCanvasFlush();
+	struct HostLcdCounters canvas = hostLcdSince(&before);
+	report("canvas", &canvas, glyphs);
+
+	// all three draw the same text
+	int wrong = 0;
+	for(int x = 10; x < 10 + glyphs * 10; x++)
+	{
+		for(int row = 0; row < ASCII_GLYPH_HEIGHT; row++)
+		{
+			uint16_t pixel = hostLcdScreenPixel(x, 100 + row);
+			wrong += hostLcdScreenPixel(x, 160 + row) != pixel;
+			wrong += hostLcdScreenPixel(x, 200 + row) != pixel;
+		}
+	}
+	CHECK(wrong == 0);
+	// a burst costs the same for every glyph, foreground pixels only set the old cost
+	CHECK(burst.indexWrites + burst.registerWrites + burst.gramWrites
+		== glyphs * (ASCII_GLYPH_WIDTH * ASCII_GLYPH_HEIGHT + 13));
+	CHECK(burst.gpioAccesses < pixels.gpioAccesses);
+	CHECK(burst.cycles < pixels.cycles);
+	// flushed tiles cover the gaps and neighbours of the glyphs too
+	CHECK(canvas.gpioAccesses < pixels.gpioAccesses);
+	CHECK(pixels.timingErrors == 0 && burst.timingErrors == 0 && canvas.timingErrors == 0);
+	return hostTestResult();
+}
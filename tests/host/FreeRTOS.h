@@ -0,0 +1,22 @@
+/* Host stand-in for FreeRTOS.h, static allocation types, heap_4
+ * statistics and the limits of RTE/RTOS/FreeRTOSConfig.h */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY 16
+#define configTOTAL_HEAP_SIZE ((size_t)8192)
+#define configMINIMAL_STACK_SIZE ((uint16_t)(128))
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICKLESS_IDLE 1
+
+typedef struct { void* dummy[11]; } StaticTimer_t;
+typedef struct { void* dummy[8]; } StaticEventGroup_t;
+
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+
+#endif
@@ -0,0 +1,22 @@
+/* Host stand-in for the PIN driver of the LPC17xx device pack */
+
+#ifndef __PIN_LPC17XX_H
+#define __PIN_LPC17XX_H
+
+#include <stdint.h>
+
+typedef struct _PIN {
+  uint8_t Portnum;
+  uint8_t Pinnum;
+} PIN;
+
+#define PIN_FUNC_0            0U
+#define PIN_PINMODE_PULLUP    0U
+#define PIN_PINMODE_REPEATER  1U
+#define PIN_PINMODE_TRISTATE  2U
+#define PIN_PINMODE_PULLDOWN  3U
+#define PIN_PINMODE_NORMAL    0U
+
+int32_t PIN_Configure(uint8_t port, uint8_t pin, uint8_t function, uint8_t mode, uint8_t open_drain);
+
+#endif
@@ -0,0 +1,111 @@
+/* Host stand-in for the CMSIS-RTOS2 API. There is one host thread:
+ * delays advance the tick count, waits on flags return what is set
+ * after hostRtosIdle had a chance to produce it */
+
+#ifndef CMSIS_OS2_H_
+#define CMSIS_OS2_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define osWaitForever         0xFFFFFFFFU
+#define osFlagsWaitAny        0x00000000U
+#define osFlagsError          0x80000000U
+#define osFlagsErrorTimeout   0xFFFFFFFEU
+#define osFlagsErrorResource  0xFFFFFFFDU
+
+typedef enum {
+  osOK = 0,
+  osError = -1
+} osStatus_t;
+
+typedef enum {
+  osKernelInactive = 0,
+  osKernelReady = 1,
+  osKernelRunning = 2
+} osKernelState_t;
+
+typedef enum {
+  osPriorityBelowNormal = 16,
+  osPriorityNormal = 24,
+  osPriorityAboveNormal = 32
+} osPriority_t;
+
+typedef enum {
+  osTimerOnce = 0,
+  osTimerPeriodic = 1
+} osTimerType_t;
+
+typedef void* osThreadId_t;
+typedef void* osTimerId_t;
+typedef void* osEventFlagsId_t;
+typedef void* osMutexId_t;
+typedef void (*osThreadFunc_t)(void* argument);
+typedef void (*osTimerFunc_t)(void* argument);
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+  void* stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+} osThreadAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+} osTimerAttr_t, osEventFlagsAttr_t, osMutexAttr_t;
+
+osStatus_t osKernelInitialize(void);
+osKernelState_t osKernelGetState(void);
+osStatus_t osKernelStart(void);
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t* attr);
+osThreadId_t osThreadGetId(void);
+void osThreadExit(void);
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osDelayUntil(uint32_t ticks);
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t* attr);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t* attr);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout);
+
+osMutexId_t osMutexNew(const osMutexAttr_t* attr);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+
+/* Runs a thread function until it would block or exits,
+ * its locals are gone after that, the next run starts it anew */
+void hostRtosRun(osThreadFunc_t func, void* argument);
+
+/* Same, but the thread may sleep for up to ticks: waits time out
+ * within them, a wait that outlasts them sleeps to their end and
+ * then blocks */
+void hostRtosRunFor(osThreadFunc_t func, void* argument, uint32_t ticks);
+
+/* Deepest stack use of all runs so far [bytes], in host frames,
+ * which are larger than the target's */
+size_t hostRtosStackUsed(void);
+
+/* Function of the thread created with name, NULL when there is none,
+ * so tests can run threads whose function is static */
+osThreadFunc_t hostRtosThreadFunc(const char* name);
+
+/* Called by every blocking wait before it looks at the flags, and
+ * again whenever its sleep moved the tick, tests set it to feed
+ * key events */
+extern void (*hostRtosIdle)(void);
+
+#endif
@@ -0,0 +1,80 @@
+/* Host stand-in for the CMSIS Cortex-M3 core header, only what the
+ * firmware uses. Core registers are plain host memory except DWT,
+ * whose cycle counter follows the bus model time of hostDevice.c */
+
+#ifndef __CORE_CM3_H_GENERIC
+#define __CORE_CM3_H_GENERIC
+
+#include <stdint.h>
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+  __IO uint32_t DHCSR;
+  __O  uint32_t DCRSR;
+  __IO uint32_t DCRDR;
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  __IO uint32_t ICSR;
+  __IO uint32_t SCR;
+} SCB_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk        (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24)
+#define SCB_SCR_SLEEPDEEP_Msk         (1UL << 2)
+#define SCB_ICSR_PENDSTSET_Msk        (1UL << 26)
+
+extern CoreDebug_Type hostCoreDebug;
+extern SysTick_Type hostSysTick;
+extern SCB_Type hostScb;
+DWT_Type* hostDwtAccess(void);
+
+#define DWT       (hostDwtAccess())
+#define CoreDebug (&hostCoreDebug)
+#define SysTick   (&hostSysTick)
+#define SCB       (&hostScb)
+
+/* Last priority set per interrupt, for tests */
+extern uint32_t hostNvicPriority[64];
+
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+  hostNvicPriority[IRQn] = priority;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  (void)IRQn;
+}
+
+/* Single threaded host, except the ring stress test which needs real barriers */
+#define __DMB() __sync_synchronize()
+#define __DSB() __sync_synchronize()
+#define __WFI()
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+#endif
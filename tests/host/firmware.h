@@ -0,0 +1,59 @@
+/* main.c has no header, these are the parts the host tests drive */
+
+#ifndef __HOST_FIRMWARE_H
+#define __HOST_FIRMWARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cmsis_os2.h>
+#include "packedFont.h"
+
+/* Display event flags of main.c */
+#define FIRMWARE_DISPLAY_FLAG_KEY_ECHO 0x0001U
+#define FIRMWARE_DISPLAY_FLAG_CLOCK    0x0010U
+#define FIRMWARE_DISPLAY_FLAG_ACTIVITY 0x0020U
+#define FIRMWARE_DISPLAY_FLAGS_ALL     0x003FU
+
+extern osEventFlagsId_t displayEvents;
+
+/* Same layout as in main.c */
+struct Date{
+	int year;
+	int month;
+	int day;
+	int hour;
+	int min;
+	int sec;
+};
+
+/* Same layout as in main.c */
+struct Frame{
+	uint16_t xStart;
+	uint16_t xEnd;
+	uint16_t yStart;
+	uint16_t yEnd;
+};
+
+/* main() of main.c, renamed for the host */
+int firmwareMain(void);
+
+void clearScreen(void);
+void invalidateScreen(void);
+void drawText(uint16_t xPos, uint16_t yPos, const char* text);
+void drawPackedLetter(uint16_t xPos, uint16_t yPos, const struct PackedFont* font, char letter);
+void gpioSetup(void);
+void configure_lpc_rtc(void);
+void displayEventsSetup(void);
+void display_task(void* argument);
+void logic_task(void* argument);
+void relockCallback(void* param);
+void rtcSecondInterruptSetup(void);
+void RTC_IRQHandler(void);
+void readRtcDate(struct Date* date);
+bool saveDateValue(int* dateArray);
+
+/* LCD_PROFILE builds only */
+void layoutProfileFields(void);
+int profileLayoutFrames(struct Frame* frames, int maxFrames);
+
+#endif
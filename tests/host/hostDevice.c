@@ -0,0 +1,207 @@
+#include "hostDevice.h"
+#include "hostLcd.h"
+#include "hostKeyMatrix.h"
+
+#include <LPC17xx.h>
+#include <PIN_LPC17xx.h>
+#include "GPIO_LPC17xx.h"
+
+#include <stddef.h>
+
+#define HOST_GPIO_PORTS 5
+#define HOST_MAIN_OSC 12000000UL
+
+/* Reset clock setup of system_LPC17xx.c, PLL0 connected, 100 MHz */
+LPC_SC_TypeDef hostSc = {.PLL0CON = 0x03, .PLL0CFG = 0x00050063, .CCLKCFG = 0x03};
+LPC_RTC_TypeDef hostRtc;
+LPC_GPIOINT_TypeDef hostGpioInt;
+CoreDebug_Type hostCoreDebug;
+SysTick_Type hostSysTick;
+SCB_Type hostScb;
+uint32_t hostNvicPriority[64];
+uint32_t SystemCoreClock = 100000000UL;
+
+static uint64_t busCycles;
+
+/* Each access gets a fresh copy of the port registers, what was
+ * written to it is applied when the next access starts */
+static struct{
+	LPC_GPIO_TypeDef scratch[HOST_GPIO_PORTS];
+	uint32_t shownPin[HOST_GPIO_PORTS];  // FIOPIN as handed out
+	uint32_t out[HOST_GPIO_PORTS];
+	uint32_t dir[HOST_GPIO_PORTS];
+	uint32_t mask[HOST_GPIO_PORTS];
+	uint32_t pinWritten[HOST_GPIO_PORTS];  // output bits changed by FIOPIN stores
+	int pending;  // port of the access not applied yet, -1 for none
+	uint64_t pendingTime;
+	uint32_t accesses;
+} gpio = {.pending = -1};
+
+static struct{
+	DWT_Type reg;
+	uint32_t shownCycles;  // CYCCNT as handed out
+	uint32_t cycles;
+	uint64_t synced;  // bus time cycles was last brought up to
+} dwt;
+
+static void commitGpio(void)
+{
+	int port = gpio.pending;
+	if(port < 0)
+	{
+		return;
+	}
+	gpio.pending = -1;
+	LPC_GPIO_TypeDef* reg = &gpio.scratch[port];
+	gpio.dir[port] = reg->FIODIR;
+	gpio.mask[port] = reg->FIOMASK;
+	uint32_t writable = ~gpio.mask[port];
+	uint32_t out = gpio.out[port];
+	if(reg->FIOPIN != gpio.shownPin[port])
+	{
+		out = (out & ~writable) | (reg->FIOPIN & writable);
+		gpio.pinWritten[port] |= out ^ gpio.out[port];
+	}
+	out |= reg->FIOSET & writable;
+	out &= ~(reg->FIOCLR & writable);
+	if(out != gpio.out[port])
+	{
+		gpio.out[port] = out;
+		hostLcdPins(gpio.out, gpio.pendingTime);
+	}
+}
+
+LPC_GPIO_TypeDef* hostGpioAccess(int port)
+{
+	commitGpio();
+	busCycles += HOST_GPIO_ACCESS_CYCLES;
+	gpio.accesses++;
+	uint32_t input = hostLcdPortInput(port) | hostKeyMatrixPortInput(port, gpio.out, gpio.dir);
+	uint32_t pin = (gpio.out[port] & gpio.dir[port]) | (input & ~gpio.dir[port]);
+	LPC_GPIO_TypeDef* reg = &gpio.scratch[port];
+	reg->FIODIR = gpio.dir[port];
+	reg->FIOMASK = gpio.mask[port];
+	reg->FIOPIN = pin;
+	reg->FIOSET = 0;
+	reg->FIOCLR = 0;
+	gpio.shownPin[port] = pin;
+	gpio.pending = port;
+	gpio.pendingTime = busCycles;
+	return reg;
+}
+
+static void syncCycleCounter(void)
+{
+	if((hostCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (dwt.reg.CTRL & DWT_CTRL_CYCCNTENA_Msk))
+	{
+		dwt.cycles += (uint32_t)(busCycles - dwt.synced);
+	}
+	dwt.synced = busCycles;
+}
+
+/* CYCCNT only counts with TRCENA and CYCCNTENA set, like the core */
+DWT_Type* hostDwtAccess(void)
+{
+	commitGpio();
+	if(dwt.reg.CYCCNT != dwt.shownCycles)
+	{
+		dwt.cycles = dwt.reg.CYCCNT;  // written by the last access
+		dwt.synced = busCycles;
+	}
+	busCycles += HOST_DWT_READ_CYCLES;
+	syncCycleCounter();
+	dwt.reg.CYCCNT = dwt.shownCycles = dwt.cycles;
+	return &dwt.reg;
+}
+
+void hostDeviceSync(void)
+{
+	commitGpio();
+}
+
+void (*hostRtcTick)(void);
+
+LPC_RTC_TypeDef* hostRtcAccess(void)
+{
+	if(hostRtcTick != NULL)
+	{
+		hostRtcTick();
+	}
+	return &hostRtc;
+}
+
+void hostRtcSetTime(uint32_t ctime0, uint32_t ctime1)
+{
+	*(volatile uint32_t*)&hostRtc.CTIME0 = ctime0;
+	*(volatile uint32_t*)&hostRtc.CTIME1 = ctime1;
+}
+
+uint64_t hostDeviceCycles(void)
+{
+	return busCycles;
+}
+
+uint32_t hostGpioAccesses(void)
+{
+	return gpio.accesses;
+}
+
+uint32_t hostGpioOutput(int port)
+{
+	commitGpio();
+	return gpio.out[port];
+}
+
+uint32_t hostGpioPinWritten(int port)
+{
+	commitGpio();
+	return gpio.pinWritten[port];
+}
+
+void SystemCoreClockUpdate(void)
+{
+	uint32_t clock = HOST_MAIN_OSC;
+	if((hostSc.PLL0CON & 0x03) == 0x03)
+	{
+		uint32_t m = (hostSc.PLL0CFG & 0x7FFF) + 1;
+		uint32_t n = ((hostSc.PLL0CFG >> 16) & 0xFF) + 1;
+		clock = (uint32_t)(2ULL * m * HOST_MAIN_OSC / n);
+	}
+	SystemCoreClock = clock / ((hostSc.CCLKCFG & 0xFF) + 1);
+}
+
+/* GPIO and PIN drivers of the device pack, on top of the FIO registers */
+
+int32_t PIN_Configure(uint8_t port, uint8_t pin, uint8_t function, uint8_t mode, uint8_t open_drain)
+{
+	return 0;
+}
+
+void GPIO_SetDir(uint32_t port_num, uint32_t pin_num, uint32_t dir)
+{
+	if(dir == GPIO_DIR_OUTPUT)
+	{
+		hostGpioAccess(port_num)->FIODIR |= 1U << pin_num;
+	}
+	else
+	{
+		hostGpioAccess(port_num)->FIODIR &= ~(1U << pin_num);
+	}
+}
+
+void GPIO_PinWrite(uint32_t port_num, uint32_t pin_num, uint32_t val)
+{
+	if(val)
+	{
+		hostGpioAccess(port_num)->FIOSET = 1U << pin_num;
+	}
+	else
+	{
+		hostGpioAccess(port_num)->FIOCLR = 1U << pin_num;
+	}
+}
+
+uint32_t GPIO_PinRead(uint32_t port_num, uint32_t pin_num)
+{
+	return (hostGpioAccess(port_num)->FIOPIN >> pin_num) & 1U;
+}
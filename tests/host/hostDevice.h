@@ -0,0 +1,36 @@
+/* Host LPC1768: register blocks in host memory and a bus cost model */
+
+#ifndef __HOST_DEVICE_H
+#define __HOST_DEVICE_H
+
+#include <stdint.h>
+
+/* Bus cost model [core cycles]. Only register accesses take time,
+ * so measured times are bus bound lower estimates */
+#define HOST_GPIO_ACCESS_CYCLES 2  // load or store to the AHB GPIO block
+#define HOST_DWT_READ_CYCLES    4  // one pass of a cycle counter wait loop
+
+/* Bus model time, what DWT->CYCCNT counts while it is enabled */
+uint64_t hostDeviceCycles(void);
+
+/* FIO register loads and stores so far */
+uint32_t hostGpioAccesses(void);
+
+/* Output register of port, after the last access took effect */
+uint32_t hostGpioOutput(int port);
+
+/* Output bits of port ever changed by a FIOPIN store,
+ * rather than by FIOSET or FIOCLR */
+uint32_t hostGpioPinWritten(int port);
+
+/* Applies the last GPIO access, register blocks are handed out
+ * before the access, so its effect is seen only by the next one */
+void hostDeviceSync(void);
+
+/* Consolidated time registers, read-only for the firmware */
+void hostRtcSetTime(uint32_t ctime0, uint32_t ctime1);
+
+/* Called before every RTC register access of the firmware */
+extern void (*hostRtcTick)(void);
+
+#endif
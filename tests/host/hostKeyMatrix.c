@@ -0,0 +1,91 @@
+#include "hostKeyMatrix.h"
+#include "keypad.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Board wiring, as keypad.c drives it */
+static const struct{
+	int port;
+	int pin;
+} rowPins[KEYPAD_ROWS] = {{0, 0}, {0, 1}, {2, 11}, {2, 12}};
+static const int colPins[KEYPAD_COLS] = {17, 18, 15, 16};  // all on port 0
+
+void (*hostKeyMatrixSample)(uint32_t rowsHigh);
+
+static uint16_t heldKeys;
+
+void hostKeyMatrixSet(uint16_t keys)
+{
+	heldKeys = keys;
+}
+
+uint16_t hostKeyMatrixKeys(void)
+{
+	return heldKeys;
+}
+
+/* Closed switches join rows and columns into nets. A net reads high
+ * when any row on it is driven high, a row driven low fighting it is
+ * taken as the weaker side. That is the worst case for ghosting: two
+ * rows sharing two columns show the fourth corner of the rectangle */
+static uint32_t highColumns(uint32_t rowsHigh)
+{
+	uint32_t rows = rowsHigh;
+	uint32_t cols = 0;
+	bool grown = true;
+	while(grown)
+	{
+		grown = false;
+		for(int row = 0; row < KEYPAD_ROWS; row++)
+		{
+			for(int col = 0; col < KEYPAD_COLS; col++)
+			{
+				if((heldKeys & (1U << (row * KEYPAD_COLS + col))) == 0)
+				{
+					continue;
+				}
+				bool rowHigh = rows & (1U << row);
+				bool colHigh = cols & (1U << col);
+				if(rowHigh != colHigh)
+				{
+					rows |= 1U << row;
+					cols |= 1U << col;
+					grown = true;
+				}
+			}
+		}
+	}
+	return cols;
+}
+
+uint32_t hostKeyMatrixPortInput(int port, const uint32_t* out, const uint32_t* dir)
+{
+	if(port != 0)
+	{
+		return 0;
+	}
+	uint32_t rowsHigh = 0;
+	for(int row = 0; row < KEYPAD_ROWS; row++)
+	{
+		uint32_t bit = 1U << rowPins[row].pin;
+		if((dir[rowPins[row].port] & out[rowPins[row].port] & bit) != 0)
+		{
+			rowsHigh |= 1U << row;
+		}
+	}
+	if(hostKeyMatrixSample != NULL)
+	{
+		hostKeyMatrixSample(rowsHigh);
+	}
+	uint32_t cols = highColumns(rowsHigh);
+	uint32_t input = 0;
+	for(int col = 0; col < KEYPAD_COLS; col++)
+	{
+		if(cols & (1U << col))
+		{
+			input |= 1U << colPins[col];
+		}
+	}
+	return input;
+}
@@ -0,0 +1,26 @@
+/* Open1768 4x4 keypad, switches without diodes between the row and
+ * column pins of keypad.c, seen through the GPIO model of hostDevice.c */
+
+#ifndef __HOST_KEY_MATRIX_H
+#define __HOST_KEY_MATRIX_H
+
+#include <stdint.h>
+
+/*****************************
+ *  Held keys, bit n is key index n,
+ *  row * KEYPAD_COLS + col
+ */
+void hostKeyMatrixSet(uint16_t keys);
+uint16_t hostKeyMatrixKeys(void);
+
+/*****************************
+ *  Called before port 0 is sampled, with bit n set
+ *  while row n is driven high. May change the held
+ *  keys, so contacts can bounce between row reads
+ */
+extern void (*hostKeyMatrixSample)(uint32_t rowsHigh);
+
+/* Used by hostDevice.c, column pins pulled up through the switches */
+uint32_t hostKeyMatrixPortInput(int port, const uint32_t* out, const uint32_t* dir);
+
+#endif
@@ -0,0 +1,59 @@
+/* Keypad driver stand-in for main.c, tests queue the events */
+
+#include "hostKeypad.h"
+
+#define HOST_KEYPAD_QUEUE 64
+
+static struct KeyEvent queue[HOST_KEYPAD_QUEUE];
+static int queueHead;
+static int queueTail;
+
+void hostKeypadPress(uint8_t key)
+{
+	struct KeyEvent press = {key, true, false, 0, 0};
+	struct KeyEvent release = {key, false, false, 0, 0};
+	queue[queueHead++ % HOST_KEYPAD_QUEUE] = press;
+	queue[queueHead++ % HOST_KEYPAD_QUEUE] = release;
+}
+
+void keypadSetup(void)
+{
+}
+
+void keypadStart(void)
+{
+}
+
+void keypadSetListener(osThreadId_t thread, uint32_t flags)
+{
+}
+
+uint16_t keypadScan(void)
+{
+	return 0;
+}
+
+bool keypadGetEvent(struct KeyEvent* event)
+{
+	if(queueTail == queueHead)
+	{
+		return false;
+	}
+	*event = queue[queueTail++ % HOST_KEYPAD_QUEUE];
+	return true;
+}
+
+uint32_t keypadScanCycles(void)
+{
+	return 0;
+}
+
+uint32_t keypadDroppedEvents(void)
+{
+	return 0;
+}
+
+uint32_t keypadWakeLatency(void)
+{
+	return 0;
+}
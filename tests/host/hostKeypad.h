@@ -0,0 +1,12 @@
+#ifndef __HOST_KEYPAD_H
+#define __HOST_KEYPAD_H
+
+#include "keypad.h"
+
+/*****************************
+ *  Queues a key down and a key up event
+ *  for keypadGetEvent
+ */
+void hostKeypadPress(uint8_t key);
+
+#endif
@@ -0,0 +1,323 @@
+#include "hostLcd.h"
+#include "hostDevice.h"
+#include "Open1768_LCD.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_LCD_REGISTERS 0x100
+#define HOST_LCD_DEVICE_CODE 0x9325
+#define HOST_LCD_GRAM_PATTERN 0x5AA5
+#define HOST_LCD_LONG_AGO (-(1LL << 40))
+
+uint16_t hostGram[LCD_GRAM_HEIGHT][LCD_GRAM_WIDTH];
+
+struct BusPins{
+	bool cs;
+	bool rs;
+	bool wr;
+	bool rd;
+	bool le;
+	bool dir;
+	bool en;
+	uint8_t data;
+};
+
+static struct{
+	uint16_t regs[HOST_LCD_REGISTERS];
+	uint16_t index;
+	uint16_t acX;
+	uint16_t acY;
+	uint16_t readValue;
+	uint8_t latched;  // D0..D7 held by the 74HC573
+	uint16_t word;    // on DB0..DB15
+	struct BusPins pins;
+	int64_t wrFall;
+	int64_t wrRise;
+	int64_t dataChange;
+	struct HostLcdCounters counters;
+	struct HostLcdRegisterWrite* trace;
+	int traceCapacity;
+	int traced;
+} lcd;
+
+static int64_t nsToCycles(uint32_t ns)
+{
+	return ((uint64_t)ns * SystemCoreClock + 999999999ULL) / 1000000000ULL;
+}
+
+void hostLcdReset()
+{
+	memset(lcd.regs, 0, sizeof(lcd.regs));
+	lcd.regs[0x03] = 0x0030;
+	lcd.regs[HADRPOS_RAM_END] = LCD_GRAM_WIDTH - 1;
+	lcd.regs[VADRPOS_RAM_END] = LCD_GRAM_HEIGHT - 1;
+	lcd.index = 0;
+	lcd.acX = 0;
+	lcd.acY = 0;
+	lcd.wrFall = HOST_LCD_LONG_AGO;
+	lcd.wrRise = HOST_LCD_LONG_AGO;
+	lcd.dataChange = HOST_LCD_LONG_AGO;
+	for(int y = 0; y < LCD_GRAM_HEIGHT; y++)
+	{
+		for(int x = 0; x < LCD_GRAM_WIDTH; x++)
+		{
+			hostGram[y][x] = HOST_LCD_GRAM_PATTERN;
+		}
+	}
+}
+
+/* Moves counter one step inside [start, end], true when it wrapped */
+static bool stepWithin(uint16_t* counter, uint16_t start, uint16_t end, bool increment)
+{
+	if(increment)
+	{
+		if(*counter >= end)
+		{
+			*counter = start;
+			return true;
+		}
+		(*counter)++;
+	}
+	else
+	{
+		if(*counter <= start)
+		{
+			*counter = end;
+			return true;
+		}
+		(*counter)--;
+	}
+	return false;
+}
+
+/* Entry mode AM selects the counter moved first, ID0 and ID1 the horizontal and vertical direction */
+static void advanceAddress(void)
+{
+	uint16_t entry = lcd.regs[ENTRYM];
+	bool vertical = entry & 0x0008;
+	bool incX = entry & 0x0010;
+	bool incY = entry & 0x0020;
+	uint16_t hsa = lcd.regs[HADRPOS_RAM_START], hea = lcd.regs[HADRPOS_RAM_END];
+	uint16_t vsa = lcd.regs[VADRPOS_RAM_START], vea = lcd.regs[VADRPOS_RAM_END];
+	if(!vertical)
+	{
+		if(stepWithin(&lcd.acX, hsa, hea, incX))
+		{
+			stepWithin(&lcd.acY, vsa, vea, incY);
+		}
+	}
+	else
+	{
+		if(stepWithin(&lcd.acY, vsa, vea, incY))
+		{
+			stepWithin(&lcd.acX, hsa, hea, incX);
+		}
+	}
+}
+
+static void busWrite(bool rs, uint16_t word)
+{
+	if(!rs)
+	{
+		lcd.index = word % HOST_LCD_REGISTERS;
+		lcd.counters.indexWrites++;
+		return;
+	}
+	if(lcd.index == DATA_RAM)
+	{
+		if(lcd.acX < LCD_GRAM_WIDTH && lcd.acY < LCD_GRAM_HEIGHT)
+		{
+			hostGram[lcd.acY][lcd.acX] = word;
+		}
+		advanceAddress();
+		lcd.counters.gramWrites++;
+		return;
+	}
+	lcd.regs[lcd.index] = word;
+	lcd.counters.registerWrites++;
+	if(lcd.traced < lcd.traceCapacity)
+	{
+		lcd.trace[lcd.traced] = (struct HostLcdRegisterWrite){lcd.index, word};
+	}
+	lcd.traced++;
+	if(lcd.index == ADRX_RAM)
+	{
+		lcd.acX = word;
+	}
+	else if(lcd.index == ADRY_RAM)
+	{
+		lcd.acY = word;
+	}
+}
+
+static uint16_t busRead(void)
+{
+	lcd.counters.reads++;
+	if(lcd.index == 0x00)
+	{
+		return HOST_LCD_DEVICE_CODE;
+	}
+	if(lcd.index == DATA_RAM)
+	{
+		return hostGram[lcd.acY % LCD_GRAM_HEIGHT][lcd.acX % LCD_GRAM_WIDTH];
+	}
+	return lcd.regs[lcd.index];
+}
+
+void hostLcdPins(const uint32_t* out, uint64_t time)
+{
+	struct BusPins prev = lcd.pins;
+	struct BusPins pins = {
+		!!(out[0] & PIN_CS), !!(out[0] & PIN_RS), !!(out[0] & PIN_WR), !!(out[0] & PIN_RD),
+		!!(out[1] & PIN_LE), !!(out[1] & PIN_DIR), !!(out[1] & PIN_EN), out[2] & 0xFF
+	};
+	int64_t now = (int64_t)time;
+	lcd.pins = pins;
+
+	if(pins.le)
+	{
+		lcd.latched = pins.data;  // transparent while LE is high
+	}
+	if(prev.le && !pins.le)
+	{
+		lcd.counters.latches++;
+	}
+	uint16_t word = (uint16_t)(pins.data << 8) | lcd.latched;
+	if(word != lcd.word)
+	{
+		if(now - lcd.wrRise < nsToCycles(LCD_T_DHW_NS))
+		{
+			lcd.counters.timingErrors++;  // data hold
+		}
+		lcd.word = word;
+		lcd.dataChange = now;
+	}
+	if((pins.rs != prev.rs || pins.cs != prev.cs) && now - lcd.wrRise < nsToCycles(LCD_T_AH_NS))
+	{
+		lcd.counters.timingErrors++;  // RS or CS hold
+	}
+	if(pins.cs)
+	{
+		return;
+	}
+	if(prev.wr && !pins.wr)
+	{
+		if(now - lcd.wrRise < nsToCycles(LCD_T_WRH_NS))
+		{
+			lcd.counters.timingErrors++;
+		}
+		lcd.wrFall = now;
+	}
+	if(!prev.wr && pins.wr)
+	{
+		if(now - lcd.wrFall < nsToCycles(LCD_T_WRL_NS) || now - lcd.dataChange < nsToCycles(LCD_T_DSW_NS))
+		{
+			lcd.counters.timingErrors++;
+		}
+		if(!pins.dir || pins.en)
+		{
+			lcd.counters.busErrors++;
+		}
+		busWrite(pins.rs, word);
+		lcd.wrRise = now;
+	}
+	if(prev.rd && !pins.rd)
+	{
+		lcd.readValue = busRead();
+	}
+}
+
+/* 74HC245 drives P2.0..P2.7 from the panel while DIR selects B to A,
+ * EN low gives D8..D15 */
+uint32_t hostLcdPortInput(int port)
+{
+	if(port != 2 || lcd.pins.dir)
+	{
+		return 0;
+	}
+	return lcd.pins.en ? (lcd.readValue & 0xFF) : (lcd.readValue >> 8);
+}
+
+void hostLcdTraceRegisters(struct HostLcdRegisterWrite* trace, int capacity)
+{
+	hostDeviceSync();
+	lcd.trace = trace;
+	lcd.traceCapacity = capacity;
+	lcd.traced = 0;
+}
+
+int hostLcdTraced(void)
+{
+	hostDeviceSync();
+	return lcd.traced;
+}
+
+void hostLcdCounters(struct HostLcdCounters* counters)
+{
+	hostDeviceSync();
+	*counters = lcd.counters;
+	counters->gpioAccesses = hostGpioAccesses();
+	counters->cycles = hostDeviceCycles();
+}
+
+struct HostLcdCounters hostLcdSince(const struct HostLcdCounters* before)
+{
+	struct HostLcdCounters now;
+	hostLcdCounters(&now);
+	now.gpioAccesses -= before->gpioAccesses;
+	now.latches -= before->latches;
+	now.indexWrites -= before->indexWrites;
+	now.registerWrites -= before->registerWrites;
+	now.gramWrites -= before->gramWrites;
+	now.reads -= before->reads;
+	now.timingErrors -= before->timingErrors;
+	now.busErrors -= before->busErrors;
+	now.cycles -= before->cycles;
+	return now;
+}
+
+uint16_t hostLcdRegister(uint16_t reg)
+{
+	hostDeviceSync();
+	return lcd.regs[reg % HOST_LCD_REGISTERS];
+}
+
+/* Panel geometry, kept apart from the driver's lcdMapPoint */
+uint16_t hostLcdScreenPixel(uint16_t x, uint16_t y)
+{
+	hostDeviceSync();
+#if   ( DISP_ORIENTATION == 90 )
+	return hostGram[LCD_GRAM_HEIGHT - 1 - x][y];
+#elif ( DISP_ORIENTATION == 180 )
+	return hostGram[LCD_GRAM_HEIGHT - 1 - y][LCD_GRAM_WIDTH - 1 - x];
+#elif ( DISP_ORIENTATION == 270 )
+	return hostGram[x][LCD_GRAM_WIDTH - 1 - y];
+#else
+	return hostGram[y][x];
+#endif
+}
+
+bool hostLcdWritePpm(const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL)
+	{
+		return false;
+	}
+	fprintf(file, "P6\n%d %d\n255\n", LCD_MAX_X, LCD_MAX_Y);
+	for(int y = 0; y < LCD_MAX_Y; y++)
+	{
+		for(int x = 0; x < LCD_MAX_X; x++)
+		{
+			uint16_t color = hostLcdScreenPixel(x, y);
+			uint8_t rgb[3] = {
+				(uint8_t)((color >> 11) * 255 / 31),
+				(uint8_t)(((color >> 5) & 0x3F) * 255 / 63),
+				(uint8_t)((color & 0x1F) * 255 / 31)
+			};
+			fwrite(rgb, 1, sizeof(rgb), file);
+		}
+	}
+	return fclose(file) == 0;
+}
@@ -0,0 +1,73 @@
+/* ILI9325 model behind the Open1768 74HC573 latch and 74HC245 buffer,
+ * decoded from the GPIO pins the driver drives */
+
+#ifndef __HOST_LCD_H
+#define __HOST_LCD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "LCD_ILI9325.h"
+
+struct HostLcdCounters{
+	uint32_t gpioAccesses;    // FIO loads and stores of all drivers
+	uint32_t latches;         // LE pulses
+	uint32_t indexWrites;
+	uint32_t registerWrites;  // data writes to registers other than GRAM
+	uint32_t gramWrites;
+	uint32_t reads;
+	uint32_t timingErrors;    // WR pulse, setup or hold shorter than Open1768_LCD.h allows
+	uint32_t busErrors;       // WR strobes while the buffer did not drive the bus
+	uint64_t cycles;          // bus model time
+};
+
+struct HostLcdRegisterWrite{
+	uint16_t reg;
+	uint16_t value;
+};
+
+/* Portrait, as the controller stores it */
+extern uint16_t hostGram[LCD_GRAM_HEIGHT][LCD_GRAM_WIDTH];
+
+/*****************************
+ *  Registers and address counter to power-on values,
+ *  GRAM is filled with a pattern, the panel does not clear it
+ */
+void hostLcdReset(void);
+
+void hostLcdCounters(struct HostLcdCounters* counters);
+
+/*****************************
+ *  Counters since snapshot before
+ */
+struct HostLcdCounters hostLcdSince(const struct HostLcdCounters* before);
+
+uint16_t hostLcdRegister(uint16_t reg);
+
+/*****************************
+ *  Logs register writes other than GRAM data into
+ *  trace from now on, up to capacity of them
+ */
+void hostLcdTraceRegisters(struct HostLcdRegisterWrite* trace, int capacity);
+
+/*****************************
+ *  Register writes since tracing started,
+ *  also those past the capacity
+ */
+int hostLcdTraced(void);
+
+/*****************************
+ *  GRAM word at screen position,
+ *  screen as rotated by DISP_ORIENTATION
+ */
+uint16_t hostLcdScreenPixel(uint16_t x, uint16_t y);
+
+/*****************************
+ *  Screen as binary PPM
+ */
+bool hostLcdWritePpm(const char* path);
+
+/* Used by hostDevice.c, new output state of all ports and pins driven by the panel side */
+void hostLcdPins(const uint32_t* out, uint64_t time);
+uint32_t hostLcdPortInput(int port);
+
+#endif
@@ -0,0 +1,36 @@
+/* Force included by tests/Makefile before every source. Takes the
+ * register layouts from the device header and moves the peripherals
+ * to host memory. GPIO accesses go through hostGpioAccess, which
+ * feeds the pins to the ILI9325 model of hostLcd.c, RTC accesses
+ * through hostRtcAccess, so tests can move the clock between them */
+
+#ifndef __HOST_LPC17XX_H
+#define __HOST_LPC17XX_H
+
+#include "../../LPC17xx.h"
+
+extern LPC_SC_TypeDef hostSc;
+extern LPC_RTC_TypeDef hostRtc;
+extern LPC_GPIOINT_TypeDef hostGpioInt;
+LPC_GPIO_TypeDef* hostGpioAccess(int port);
+LPC_RTC_TypeDef* hostRtcAccess(void);
+
+#undef LPC_SC
+#undef LPC_RTC
+#undef LPC_GPIOINT
+#undef LPC_GPIO0
+#undef LPC_GPIO1
+#undef LPC_GPIO2
+#undef LPC_GPIO3
+#undef LPC_GPIO4
+
+#define LPC_SC      (&hostSc)
+#define LPC_RTC     (hostRtcAccess())
+#define LPC_GPIOINT (&hostGpioInt)
+#define LPC_GPIO0   (hostGpioAccess(0))
+#define LPC_GPIO1   (hostGpioAccess(1))
+#define LPC_GPIO2   (hostGpioAccess(2))
+#define LPC_GPIO3   (hostGpioAccess(3))
+#define LPC_GPIO4   (hostGpioAccess(4))
+
+#endif
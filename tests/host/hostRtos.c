@@ -0,0 +1,303 @@
+/* Single host thread in place of FreeRTOS: threads are run only by
+ * hostRtosRun, delays advance the tick, blocking waits give hostRtosIdle
+ * a chance to produce what they wait for. Runs use a painted stack of
+ * their own, so the deepest use of all runs can be read back */
+
+#include <cmsis_os2.h>
+#include "FreeRTOS.h"
+
+#include <ucontext.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_RTOS_OBJECTS 16
+#define HOST_RTOS_CONTROL_BLOCK 64  // heap bytes of a control block, about what heap_4 takes
+#define HOST_RTOS_STACK_WORDS configMINIMAL_STACK_SIZE  // of threads without stack_size
+#define HOST_RTOS_RUN_STACK 0x40000  // host frames, much larger than the target's
+#define HOST_RTOS_STACK_PAINT 0xA5
+
+void (*hostRtosIdle)(void);
+
+static osKernelState_t kernelState = osKernelInactive;
+static uint32_t tickCount;
+static uint32_t threadFlags;
+static uint32_t objects[HOST_RTOS_OBJECTS];  // event flags of each object
+static struct{
+	const char* name;
+	osThreadFunc_t func;
+} threads[HOST_RTOS_OBJECTS];  // of objects that are threads
+static int objectCount;
+static size_t heapFree = configTOTAL_HEAP_SIZE;
+static size_t heapMinimum = configTOTAL_HEAP_SIZE;
+static ucontext_t runReturn;
+static ucontext_t runThread;
+static uint8_t runStack[HOST_RTOS_RUN_STACK] __attribute__((aligned(16)));
+static bool runStackPainted;
+static osThreadFunc_t runFunc;
+static void* runArgument;
+static bool running;
+static uint32_t runEnd;  // tick a run may sleep until
+
+/* Objects are never deleted, control blocks and stacks without static memory come from the heap */
+static void* newObject(size_t heapBytes)
+{
+	if(objectCount == HOST_RTOS_OBJECTS || heapBytes > heapFree)
+	{
+		return NULL;
+	}
+	heapFree -= heapBytes;
+	if(heapFree < heapMinimum)
+	{
+		heapMinimum = heapFree;
+	}
+	return &objects[objectCount++];
+}
+
+static size_t controlBlockBytes(const void* cbMem)
+{
+	return cbMem == NULL ? HOST_RTOS_CONTROL_BLOCK : 0;
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+	return heapFree;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+	return heapMinimum;
+}
+
+/* Flags wanted from word, cleared when taken. Outside a run a wait
+ * times out at once and waits forever only if the idle hook delivers */
+static uint32_t takeFlags(uint32_t* word, uint32_t flags, uint32_t timeout)
+{
+	uint32_t slept = 0;
+	while(true)
+	{
+		if((*word & flags) == 0 && hostRtosIdle != NULL)
+		{
+			hostRtosIdle();
+		}
+		uint32_t taken = *word & flags;
+		if(taken != 0)
+		{
+			*word &= ~taken;
+			return taken;
+		}
+		if(timeout == 0)
+		{
+			return osFlagsErrorResource;
+		}
+		if(!running)
+		{
+			if(timeout == osWaitForever)
+			{
+				fprintf(stderr, "host rtos: waiting forever, nothing will wake the thread\n");
+				abort();
+			}
+			tickCount += timeout;
+			return osFlagsErrorTimeout;
+		}
+		int32_t left = (int32_t)(runEnd - tickCount);
+		if(left <= 0)
+		{
+			setcontext(&runReturn);  // the task would block
+		}
+		if(timeout != osWaitForever && timeout - slept <= (uint32_t)left)
+		{
+			tickCount += timeout - slept;
+			return osFlagsErrorTimeout;
+		}
+		tickCount += left;
+		slept += left;
+	}
+}
+
+osStatus_t osKernelInitialize(void)
+{
+	kernelState = osKernelReady;
+	return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+	return kernelState;
+}
+
+osStatus_t osKernelStart(void)
+{
+	kernelState = osKernelRunning;
+	return osOK;
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+	return tickCount;
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+	return 1000;
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t* attr)
+{
+	size_t bytes = HOST_RTOS_CONTROL_BLOCK + HOST_RTOS_STACK_WORDS * sizeof(uint32_t);
+	if(attr != NULL)
+	{
+		bytes = controlBlockBytes(attr->cb_mem);
+		if(attr->stack_mem == NULL)
+		{
+			bytes += attr->stack_size != 0 ? attr->stack_size : HOST_RTOS_STACK_WORDS * sizeof(uint32_t);
+		}
+	}
+	uint32_t* thread = newObject(bytes);
+	if(thread != NULL)
+	{
+		threads[thread - objects].name = attr != NULL ? attr->name : NULL;
+		threads[thread - objects].func = func;
+	}
+	return thread;
+}
+
+osThreadFunc_t hostRtosThreadFunc(const char* name)
+{
+	for(int n = 0; n < objectCount; n++)
+	{
+		if(threads[n].name != NULL && strcmp(threads[n].name, name) == 0)
+		{
+			return threads[n].func;
+		}
+	}
+	return NULL;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+	return &threadFlags;
+}
+
+void osThreadExit(void)
+{
+	if(running)
+	{
+		setcontext(&runReturn);
+	}
+}
+
+static void runFunction(void)
+{
+	runFunc(runArgument);
+}
+
+void hostRtosRunFor(osThreadFunc_t func, void* argument, uint32_t ticks)
+{
+	if(!runStackPainted)
+	{
+		memset(runStack, HOST_RTOS_STACK_PAINT, sizeof(runStack));
+		runStackPainted = true;
+	}
+	runFunc = func;
+	runArgument = argument;
+	running = true;
+	runEnd = tickCount + ticks;
+	getcontext(&runThread);
+	runThread.uc_stack.ss_sp = runStack;
+	runThread.uc_stack.ss_size = sizeof(runStack);
+	runThread.uc_link = &runReturn;  // returning ends the run too
+	makecontext(&runThread, runFunction, 0);
+	swapcontext(&runReturn, &runThread);
+	running = false;
+}
+
+size_t hostRtosStackUsed(void)
+{
+	size_t untouched = 0;
+	while(runStackPainted && untouched < sizeof(runStack) && runStack[untouched] == HOST_RTOS_STACK_PAINT)
+	{
+		untouched++;
+	}
+	return runStackPainted ? sizeof(runStack) - untouched : 0;
+}
+
+void hostRtosRun(osThreadFunc_t func, void* argument)
+{
+	hostRtosRunFor(func, argument, 0);
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+	threadFlags |= flags;
+	return threadFlags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+	return takeFlags(&threadFlags, flags, timeout);
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+	tickCount += ticks;
+	return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+	if((int32_t)(ticks - tickCount) > 0)
+	{
+		tickCount = ticks;
+	}
+	return osOK;
+}
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t* attr)
+{
+	return newObject(controlBlockBytes(attr != NULL ? attr->cb_mem : NULL));
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+{
+	return osOK;
+}
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t* attr)
+{
+	return newObject(controlBlockBytes(attr != NULL ? attr->cb_mem : NULL));
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
+{
+	*(uint32_t*)ef_id |= flags;
+	return *(uint32_t*)ef_id;
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags)
+{
+	uint32_t previous = *(uint32_t*)ef_id;
+	*(uint32_t*)ef_id &= ~flags;
+	return previous;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+	return takeFlags((uint32_t*)ef_id, flags, timeout);
+}
+
+osMutexId_t osMutexNew(const osMutexAttr_t* attr)
+{
+	return newObject(controlBlockBytes(attr != NULL ? attr->cb_mem : NULL));
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+	return osOK;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+	return osOK;
+}
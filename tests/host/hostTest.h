@@ -0,0 +1,33 @@
+/* Checks for the host tests, a test returns hostTestResult() from main */
+
+#ifndef __HOST_TEST_H
+#define __HOST_TEST_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+static int hostTestFailures;
+
+#define CHECK(condition) hostCheck((condition), #condition, __FILE__, __LINE__)
+
+static inline bool hostCheck(bool ok, const char* condition, const char* file, int line)
+{
+	if(!ok)
+	{
+		hostTestFailures++;
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+	}
+	return ok;
+}
+
+static inline int hostTestResult(void)
+{
+	if(hostTestFailures > 0)
+	{
+		fprintf(stderr, "%d checks failed\n", hostTestFailures);
+		return 1;
+	}
+	return 0;
+}
+
+#endif
@@ -0,0 +1,14 @@
+/* Host stand-in for system_LPC17xx.h */
+
+#ifndef __SYSTEM_LPC17xx_H
+#define __SYSTEM_LPC17xx_H
+
+#include <stdint.h>
+
+extern uint32_t SystemCoreClock;
+
+/* Clock from hostSc: 12 MHz main oscillator, through PLL0 while
+ * PLL0CON has enable and connect set, then CCLKCFG */
+void SystemCoreClockUpdate(void);
+
+#endif
@@ -0,0 +1,123 @@
+/* Debouncer fed with key traces, one character per scan. Keys are
+ * held on the key matrix model and read back by keypadScan, ghosted
+ * scans are dropped like the scan task does */
+
+#include "hostTest.h"
+#include "hostKeyMatrix.h"
+#include "keypad.h"
+
+#include <string.h>
+
+#define KEY 5
+
+struct Trace{
+	struct KeyEvent events[16];
+	int count;
+};
+
+static uint16_t traceKeys = 1U << KEY;  // keys the trace opens and closes
+static uint16_t steadyKeys;             // held through the whole trace
+static uint32_t bounceRow = KEY / KEYPAD_COLS;
+static uint16_t heldKeys;
+static uint16_t bounceKeys;
+
+/* Bouncing keys are closed only while bounceRow is driven alone, so a single row read sees them */
+static void sample(uint32_t rowsHigh)
+{
+	hostKeyMatrixSet(rowsHigh == 1U << bounceRow ? heldKeys | bounceKeys : heldKeys);
+}
+
+/* '1' trace keys closed, '0' open, 'b' closed for the read of bounceRow only, one scan period each */
+static void feed(struct KeypadDebouncer* debouncer, const char* scans, struct Trace* trace)
+{
+	static uint16_t trustedKeys;
+	trace->count = 0;
+	for(const char* scan = scans; *scan != '\0'; scan++)
+	{
+		heldKeys = steadyKeys | (*scan == '1' ? traceKeys : 0);
+		bounceKeys = *scan == 'b' ? traceKeys : 0;
+		uint16_t keys = keypadScan();
+		if(!keypadIsGhosted(keys))
+		{
+			trustedKeys = keys;
+		}
+		struct KeyEvent events[KEYPAD_KEYS];
+		int count = keypadDebounce(debouncer, trustedKeys, events, KEYPAD_KEYS);
+		for(int n = 0; n < count && trace->count < 16; n++)
+		{
+			trace->events[trace->count++] = events[n];
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	struct KeypadDebouncer debouncer;
+	struct Trace trace;
+	memset(&debouncer, 0, sizeof(debouncer));
+	keypadSetup();
+	hostKeyMatrixSample = sample;
+
+	// clean press and release, reported after the debounce time
+	feed(&debouncer, "111", &trace);
+	CHECK(trace.count == 1 && trace.events[0].key == KEY && trace.events[0].pressed);
+	CHECK(trace.events[0].latency == KEYPAD_DEBOUNCE_TIME);
+	feed(&debouncer, "000", &trace);
+	CHECK(trace.count == 1 && !trace.events[0].pressed);
+	CHECK(trace.events[0].latency == KEYPAD_DEBOUNCE_TIME);
+
+	// bouncing contact, latency runs from the first edge
+	feed(&debouncer, "1010111", &trace);
+	CHECK(trace.count == 1 && trace.events[0].pressed);
+	CHECK(trace.events[0].latency == 7 * KEYPAD_SCAN_PERIOD);
+	feed(&debouncer, "011000", &trace);
+	CHECK(trace.count == 1 && !trace.events[0].pressed);
+	CHECK(trace.events[0].latency == 6 * KEYPAD_SCAN_PERIOD);
+
+	// a glitch is forgotten once the key stayed back for the debounce time
+	feed(&debouncer, "1000", &trace);
+	CHECK(trace.count == 0);
+	CHECK(debouncer.edgeKeys == 0);
+	feed(&debouncer, "111", &trace);
+	CHECK(trace.count == 1 && trace.events[0].latency == KEYPAD_DEBOUNCE_TIME);
+	feed(&debouncer, "000", &trace);
+
+	// contact closed during its own row read only, one scan is a glitch too
+	feed(&debouncer, "0b0000", &trace);
+	CHECK(trace.count == 0 && debouncer.edgeKeys == 0);
+	feed(&debouncer, "bbb", &trace);
+	CHECK(trace.count == 1 && trace.events[0].key == KEY && trace.events[0].pressed);
+	feed(&debouncer, "000", &trace);
+	CHECK(trace.count == 1 && !trace.events[0].pressed);
+
+	// held key repeats, repeats carry no latency
+	char held[KEYPAD_REPEAT_DELAY / KEYPAD_SCAN_PERIOD + KEYPAD_DEBOUNCE_TIME / KEYPAD_SCAN_PERIOD + 1];
+	memset(held, '1', sizeof(held) - 1);
+	held[sizeof(held) - 1] = '\0';
+	feed(&debouncer, held, &trace);
+	CHECK(trace.count == 2 && trace.events[1].repeat && trace.events[1].latency == 0);
+	feed(&debouncer, "000", &trace);
+
+	// contact chattering for longer than the counter holds
+	static char chatter[2 * (UINT16_MAX / KEYPAD_SCAN_PERIOD) + 4];
+	for(unsigned int n = 0; n < sizeof(chatter) - 4; n++)
+	{
+		chatter[n] = n % 2 ? '0' : '1';
+	}
+	strcpy(&chatter[sizeof(chatter) - 4], "111");
+	feed(&debouncer, chatter, &trace);
+	CHECK(trace.count == 1 && trace.events[0].pressed && trace.events[0].latency == UINT16_MAX);
+	feed(&debouncer, "000", &trace);
+	CHECK(trace.count == 1 && !trace.events[0].pressed);
+
+	// with two keys of row 1 held, key 0 bouncing during the row 0 read
+	// brings the ghost of key 1 along, those scans are not trusted
+	steadyKeys = 0x0030;
+	feed(&debouncer, "000", &trace);
+	CHECK(trace.count == 2 && debouncer.stableKeys == 0x0030);
+	traceKeys = 0x0001;
+	bounceRow = 0;
+	feed(&debouncer, "bbbbb0", &trace);
+	CHECK(trace.count == 0 && debouncer.stableKeys == 0x0030 && debouncer.edgeKeys == 0);
+	return hostTestResult();
+}
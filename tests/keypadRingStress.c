@@ -0,0 +1,111 @@
+/* Key event ring between two host threads, the producer in place of
+ * the scan task or an ISR. Every event carries its sequence number,
+ * a torn copy or a lost, repeated or reordered event shows in it */
+
+#include "hostTest.h"
+#include "keyEventRing.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define EVENTS 2000000U
+#define BURST (KEYPAD_EVENT_RING_LEN * 3 / 2)  // overfills the ring without waiting
+
+static struct KeyEventRing ring;
+static bool producerWaits;
+static bool produced;
+
+static struct KeyEvent sequenceEvent(uint32_t sequence)
+{
+	struct KeyEvent event = {
+		sequence % KEYPAD_KEYS, sequence & 1, (sequence >> 1) & 1, (uint16_t)(sequence * 7), sequence
+	};
+	return event;
+}
+
+static bool isSequenceEvent(const struct KeyEvent* event)
+{
+	struct KeyEvent expected = sequenceEvent(event->timestamp);
+	return event->key == expected.key && event->pressed == expected.pressed
+		&& event->repeat == expected.repeat && event->latency == expected.latency;
+}
+
+static void* produce(void* argument)
+{
+	for(uint32_t sequence = 0; sequence < EVENTS; sequence++)
+	{
+		struct KeyEvent event = sequenceEvent(sequence);
+		while(producerWaits && ring.head - ring.tail == KEYPAD_EVENT_RING_LEN)
+		{
+			sched_yield();  // one CPU hosts may run the consumer only now
+		}
+		keyEventRingPush(&ring, &event);
+		if(!producerWaits && sequence % BURST == BURST - 1)
+		{
+			while(ring.head != ring.tail)
+			{
+				sched_yield();  // next burst once the consumer caught up
+			}
+		}
+	}
+	__atomic_store_n(&produced, true, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/* Events taken until the producer is done and the ring is empty */
+static uint32_t consume(pthread_t producer, uint32_t* torn, uint32_t* outOfOrder)
+{
+	uint32_t received = 0;
+	uint32_t next = 0;
+	struct KeyEvent event;
+	while(true)
+	{
+		bool done = __atomic_load_n(&produced, __ATOMIC_ACQUIRE);
+		if(!keyEventRingPop(&ring, &event))
+		{
+			if(done)
+			{
+				break;
+			}
+			sched_yield();
+			continue;
+		}
+		*torn += !isSequenceEvent(&event);
+		if(producerWaits ? event.timestamp != next : event.timestamp < next)
+		{
+			(*outOfOrder)++;
+		}
+		next = event.timestamp + 1;
+		received++;
+	}
+	pthread_join(producer, NULL);
+	return received;
+}
+
+static void runStress(bool waits)
+{
+	ring = (struct KeyEventRing){0};
+	producerWaits = waits;
+	produced = false;
+	pthread_t producer;
+	if(!CHECK(pthread_create(&producer, NULL, produce, NULL) == 0))
+	{
+		return;
+	}
+	uint32_t torn = 0;
+	uint32_t outOfOrder = 0;
+	uint32_t received = consume(producer, &torn, &outOfOrder);
+	printf("%-9s %7u received %7u dropped %u torn %u out of order\n", waits ? "lossless" : "lossy",
+		received, ring.dropped, torn, outOfOrder);
+	CHECK(torn == 0 && outOfOrder == 0);
+	CHECK(received + ring.dropped == EVENTS);
+	CHECK(!waits || ring.dropped == 0);
+}
+
+int main(int argc, char** argv)
+{
+	runStress(true);   // producer waits for room, nothing may be lost
+	runStress(false);  // producer waits only between bursts, drops are counted
+	return hostTestResult();
+}
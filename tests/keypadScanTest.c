@@ -0,0 +1,75 @@
+/* keypadScan of keypad.c on the key matrix model: held keys of any
+ * count come back as one mask, a rectangle corner read through the
+ * matrix is flagged, and rows are driven by FIOSET and FIOCLR only */
+
+#include "hostTest.h"
+#include "hostDevice.h"
+#include "hostKeyMatrix.h"
+#include "keypad.h"
+
+#include <stdio.h>
+
+#define ROW_PINS_PORT0 ((1U << 0) | (1U << 1))
+#define ROW_PINS_PORT2 ((1U << 11) | (1U << 12))
+
+static uint32_t rowsSampled;  // bit n set once row n was sampled driven alone
+
+static void sample(uint32_t rowsHigh)
+{
+	if(rowsHigh != 0 && (rowsHigh & (rowsHigh - 1)) == 0)
+	{
+		rowsSampled |= rowsHigh;
+	}
+}
+
+static uint16_t scanHeld(uint16_t keys)
+{
+	hostKeyMatrixSet(keys);
+	return keypadScan();
+}
+
+int main(int argc, char** argv)
+{
+	keypadSetup();
+	hostKeyMatrixSample = sample;
+
+	// rollover, any number of keys as long as no two rows share two columns
+	static const uint16_t rollover[] = {
+		0x0020,  // single key
+		0x0021,  // two keys, different rows and columns
+		0x0003,  // two keys of a row
+		0x0011,  // two keys of a column
+		0x000F,  // whole row
+		0x1111,  // whole column
+		0x8421,  // diagonal
+		0x0000
+	};
+	for(unsigned int n = 0; n < sizeof(rollover) / sizeof(rollover[0]); n++)
+	{
+		uint16_t keys = scanHeld(rollover[n]);
+		CHECK(keys == rollover[n]);
+		CHECK(!keypadIsGhosted(keys));
+	}
+
+	// L of three keys, row 0 reads the fourth corner through the other two
+	uint16_t ghosted = scanHeld(0x0031);
+	CHECK(ghosted == 0x0033);
+	CHECK(keypadIsGhosted(ghosted));
+	CHECK(!keypadIsGhosted(scanHeld(0x0030)));
+	CHECK(!keypadIsGhosted(scanHeld(0x0011)));
+
+	// every row driven alone, never through FIOPIN
+	CHECK(rowsSampled == (1U << KEYPAD_ROWS) - 1);
+	CHECK((hostGpioPinWritten(0) & ROW_PINS_PORT0) == 0);
+	CHECK((hostGpioPinWritten(2) & ROW_PINS_PORT2) == 0);
+
+	hostKeyMatrixSet(0x0021);
+	uint64_t start = hostDeviceCycles();
+	uint32_t accesses = hostGpioAccesses();
+	keypadScan();
+	uint64_t cycles = hostDeviceCycles() - start;
+	printf("keypad scan %llu cycles, %u GPIO accesses, %.2f us at %u MHz\n", (unsigned long long)cycles,
+		hostGpioAccesses() - accesses, cycles * 1e6 / SystemCoreClock, (unsigned)(SystemCoreClock / 1000000));
+	CHECK(cycles >= KEYPAD_ROWS * KEYPAD_SETTLE_US * (SystemCoreClock / 1000000));
+	return hostTestResult();
+}
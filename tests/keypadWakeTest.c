@@ -0,0 +1,78 @@
+/* Wake from tickless sleep on a key: sleep exit to the key interrupt
+ * is taken only when the key ended the sleep, the scan task reports
+ * the press one debounce time after the wake */
+
+#include "hostTest.h"
+#include "hostDevice.h"
+#include "hostKeyMatrix.h"
+#include "keypad.h"
+#include "lowPower.h"
+
+#include <LPC17xx.h>
+#include <stdio.h>
+
+#define KEY        5
+#define HOLD_TICKS 100
+
+void EINT3_IRQHandler(void);
+
+static uint32_t releaseTick;
+
+static void releaseAfterHold(uint32_t rowsHigh)
+{
+	if((int32_t)(osKernelGetTickCount() - releaseTick) >= 0)
+	{
+		hostKeyMatrixSet(0);
+	}
+}
+
+/* Tickless sleep of the port, suppressed period LOAD, ended at VAL */
+static void sleepUntil(uint32_t val, bool tickPending)
+{
+	lowPowerSleepEnter();
+	SysTick->LOAD = SystemCoreClock / 1000 * 100 - 1;
+	SysTick->VAL = val;
+	SCB->ICSR = tickPending ? SCB_ICSR_PENDSTSET_Msk : 0;
+	lowPowerSleepExit();
+}
+
+int main(int argc, char** argv)
+{
+	keypadSetup();
+	keypadStart();
+	osThreadFunc_t keypadThread = hostRtosThreadFunc("keypad");
+	if(!CHECK(keypadThread != NULL))
+	{
+		return hostTestResult();
+	}
+	hostRtosRun(keypadThread, NULL);  // arms the key interrupt and sleeps
+
+	// woken by the tick, a key interrupt later is no wake latency
+	struct LowPowerResidency residency;
+	sleepUntil(0, true);
+	EINT3_IRQHandler();
+	lowPowerGetResidency(&residency);
+	CHECK(residency.wakeCycles == 0);
+	CHECK(residency.sleepCycles == 2 * SysTick->LOAD + 1);
+
+	// woken by the key
+	sleepUntil(SysTick->LOAD / 2, false);
+	hostKeyMatrixSet(1U << KEY);
+	EINT3_IRQHandler();
+	lowPowerGetResidency(&residency);
+	CHECK(residency.wakeCycles > 0);
+
+	releaseTick = osKernelGetTickCount() + HOLD_TICKS;
+	hostKeyMatrixSample = releaseAfterHold;
+	hostRtosRunFor(keypadThread, NULL, 2 * HOLD_TICKS);
+	struct KeyEvent press;
+	struct KeyEvent release;
+	CHECK(keypadGetEvent(&press) && press.key == KEY && press.pressed);
+	CHECK(keypadGetEvent(&release) && release.key == KEY && !release.pressed);
+	CHECK(!keypadGetEvent(&release));
+	CHECK(keypadWakeLatency() == KEYPAD_DEBOUNCE_TIME);
+	// the bus model has no exception entry, the host figure is the handler's own part
+	printf("sleep exit to key interrupt %u cycles, key interrupt to first event %u ms\n",
+		residency.wakeCycles, keypadWakeLatency());
+	return hostTestResult();
+}
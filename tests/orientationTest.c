@@ -0,0 +1,138 @@
+/* ILI9325 address counter in every DISP_ORIENTATION: windows and bursts
+ * fill screen rectangles row by row, and the profile report is laid out
+ * clear of the screen fields, built once per angle with LCD_PROFILE */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+
+#include <stdio.h>
+
+#define LAYOUT_FRAMES 32
+
+#define WINDOW_X 5
+#define WINDOW_Y 11
+#define WINDOW_W 37
+#define WINDOW_H 23
+
+/* GRAM row and column of screen origin and of the pixel right of it */
+struct GramPoint{
+	int row;
+	int col;
+};
+
+#if   ( DISP_ORIENTATION == 90 )
+static const struct GramPoint ORIGIN = {LCD_GRAM_HEIGHT - 1, 0}, NEXT_X = {LCD_GRAM_HEIGHT - 2, 0};
+#elif ( DISP_ORIENTATION == 180 )
+static const struct GramPoint ORIGIN = {LCD_GRAM_HEIGHT - 1, LCD_GRAM_WIDTH - 1}, NEXT_X = {LCD_GRAM_HEIGHT - 1, LCD_GRAM_WIDTH - 2};
+#elif ( DISP_ORIENTATION == 270 )
+static const struct GramPoint ORIGIN = {0, LCD_GRAM_WIDTH - 1}, NEXT_X = {1, LCD_GRAM_WIDTH - 1};
+#else
+static const struct GramPoint ORIGIN = {0, 0}, NEXT_X = {0, 1};
+#endif
+
+static uint16_t windowWord(int n)
+{
+	return (uint16_t)(0x8000 | n);
+}
+
+/* Window pixels hold their stream index, row by row */
+static int windowMismatches(void)
+{
+	int mismatches = 0;
+	for(int y = 0; y < WINDOW_H; y++)
+	{
+		for(int x = 0; x < WINDOW_W; x++)
+		{
+			if(hostLcdScreenPixel(WINDOW_X + x, WINDOW_Y + y) != windowWord(y * WINDOW_W + x))
+			{
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+static bool framesOverlap(const struct Frame* frame, const struct Frame* other)
+{
+	return frame->xStart <= other->xEnd && other->xStart <= frame->xEnd
+		&& frame->yStart <= other->yEnd && other->yStart <= frame->yEnd;
+}
+
+/* Every text field on screen, none covers another */
+static void checkLayout(void)
+{
+	struct Frame frames[LAYOUT_FRAMES];
+	layoutProfileFields();
+	int count = profileLayoutFrames(frames, LAYOUT_FRAMES);
+	CHECK(count > 7 && count < LAYOUT_FRAMES);
+	for(int n = 0; n < count; n++)
+	{
+		CHECK(frames[n].xEnd < LCD_MAX_X && frames[n].yEnd < LCD_MAX_Y);
+		for(int other = n + 1; other < count; other++)
+		{
+			if(!CHECK(!framesOverlap(&frames[n], &frames[other])))
+			{
+				fprintf(stderr, "field %d at %d,%d overlaps field %d at %d,%d\n", n, frames[n].xStart, frames[n].yStart,
+					other, frames[other].xStart, frames[other].yStart);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	printf("DISP_ORIENTATION %3d, screen %dx%d\n", DISP_ORIENTATION, LCD_MAX_X, LCD_MAX_Y);
+	CHECK(hostLcdRegister(ENTRYM) == LCD_ENTRY_MODE);
+	uint16_t background = hostLcdScreenPixel(WINDOW_X - 1, WINDOW_Y);
+
+	// burst fills the window row by row, nothing around it
+	lcdSetWindow(WINDOW_X, WINDOW_X + WINDOW_W - 1, WINDOW_Y, WINDOW_Y + WINDOW_H - 1);
+	lcdWriteIndex(DATA_RAM);
+	lcdBeginDataStream();
+	for(int n = 0; n < WINDOW_W * WINDOW_H; n++)
+	{
+		lcdStreamData(windowWord(n));
+	}
+	lcdEndDataStream();
+	CHECK(windowMismatches() == 0);
+	CHECK(hostLcdScreenPixel(WINDOW_X - 1, WINDOW_Y) == background);
+	CHECK(hostLcdScreenPixel(WINDOW_X + WINDOW_W, WINDOW_Y + WINDOW_H - 1) == background);
+	CHECK(hostLcdScreenPixel(WINDOW_X, WINDOW_Y - 1) == background);
+	CHECK(hostLcdScreenPixel(WINDOW_X + WINDOW_W - 1, WINDOW_Y + WINDOW_H) == background);
+
+	// the counter wraps inside the window, back to its top left corner
+	lcdWriteData(LCDRed);
+	CHECK(hostLcdScreenPixel(WINDOW_X, WINDOW_Y) == LCDRed);
+	CHECK(hostLcdScreenPixel(WINDOW_X + 1, WINDOW_Y) == windowWord(1));
+
+	// cursor in each screen corner
+	const uint16_t corners[4][2] = {{0, 0}, {LCD_MAX_X - 1, 0}, {0, LCD_MAX_Y - 1}, {LCD_MAX_X - 1, LCD_MAX_Y - 1}};
+	lcdSetWindow(0, LCD_MAX_X - 1, 0, LCD_MAX_Y - 1);
+	for(int n = 0; n < 4; n++)
+	{
+		lcdSetCursor(corners[n][0], corners[n][1]);
+		lcdWriteIndex(DATA_RAM);
+		lcdWriteData(windowWord(n));
+	}
+	for(int n = 0; n < 4; n++)
+	{
+		CHECK(hostLcdScreenPixel(corners[n][0], corners[n][1]) == windowWord(n));
+	}
+
+	// screen origin and x direction on the portrait GRAM
+	lcdSetCursor(0, 0);
+	lcdWriteIndex(DATA_RAM);
+	lcdWriteData(LCDGreen);
+	lcdWriteData(LCDBlue);
+	CHECK(hostGram[ORIGIN.row][ORIGIN.col] == LCDGreen);
+	CHECK(hostGram[NEXT_X.row][NEXT_X.col] == LCDBlue);
+
+	checkLayout();
+	return hostTestResult();
+}
@@ -0,0 +1,77 @@
+/* Packed digits as decoded by drawPackedLetter against the 2x EPX
+ * upscale of the asciiLib glyphs that tools/fontgen.py encoded */
+
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+#include "asciiLib.h"
+
+static int glyphPixel(const unsigned char* glyph, int y, int x)
+{
+	if(y < 0 || y >= ASCII_GLYPH_HEIGHT || x < 0 || x >= ASCII_GLYPH_WIDTH)
+	{
+		return 0;
+	}
+	return (glyph[y] >> (ASCII_GLYPH_WIDTH - 1 - x)) & 1;
+}
+
+/* Same corner rules as scale2x of tools/fontgen.py */
+static int epxPixel(const unsigned char* glyph, int y, int x)
+{
+	int srcY = y / 2;
+	int srcX = x / 2;
+	int p = glyphPixel(glyph, srcY, srcX);
+	int a = glyphPixel(glyph, srcY - 1, srcX);
+	int b = glyphPixel(glyph, srcY, srcX + 1);
+	int c = glyphPixel(glyph, srcY, srcX - 1);
+	int d = glyphPixel(glyph, srcY + 1, srcX);
+	switch((y % 2) * 2 + x % 2)
+	{
+		case 0: return (c == a && c != d && a != b) ? a : p;
+		case 1: return (a == b && a != c && b != d) ? b : p;
+		case 2: return (d == c && d != b && c != a) ? c : p;
+		default: return (b == d && b != a && d != c) ? d : p;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	lcdCanvasInvalidate();
+	clearScreen();
+	lcdCanvasFlush();
+
+	const struct PackedFont* font = &FONT_DIGITS_16X32;
+	CHECK(font->width == 2 * ASCII_GLYPH_WIDTH && font->height == 2 * ASCII_GLYPH_HEIGHT);
+	for(char digit = '0'; digit <= '9'; digit++)
+	{
+		uint16_t xPos = 4 + (digit - '0') * (font->width + 4);
+		drawPackedLetter(xPos, 40, font, digit);
+	}
+	lcdCanvasFlush();
+
+	for(char digit = '0'; digit <= '9'; digit++)
+	{
+		const unsigned char* glyph = GetASCIIGlyph(ASCII_8X16_MS_Gothic, digit);
+		uint16_t xPos = 4 + (digit - '0') * (font->width + 4);
+		int wrong = 0;
+		for(int y = 0; y < font->height; y++)
+		{
+			for(int x = 0; x < font->width; x++)
+			{
+				uint16_t expected = epxPixel(glyph, y, x) ? LCDBlack : LCDWhite;
+				wrong += hostLcdScreenPixel(xPos + x, 40 + y) != expected;
+			}
+		}
+		if(!CHECK(wrong == 0))
+		{
+			fprintf(stderr, "digit %c: %d pixels differ\n", digit, wrong);
+		}
+	}
+	return hostTestResult();
+}
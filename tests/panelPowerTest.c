@@ -0,0 +1,144 @@
+/* Panel power steps of the display task: 8 colors after 30 s without
+ * keys, standby after 60 s, back to full colors on the next key with
+ * the retained screen, nothing drawn while the panel is in standby */
+
+#include "hostDevice.h"
+#include "hostLcd.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "Open1768_LCD.h"
+#include "LCD_ILI9325.h"
+#include "lcdCanvas.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DIM_TICKS     30000
+#define STANDBY_TICKS 60000
+#define RUN_TICKS     (STANDBY_TICKS + 5000)  // some standby, then a key
+#define TRACE_LEN     256
+
+static uint16_t retained[LCD_GRAM_HEIGHT][LCD_GRAM_WIDTH];
+static struct HostLcdRegisterWrite trace[TRACE_LEN];
+static struct HostLcdCounters standbyStart;
+static uint32_t startTick;
+static uint32_t keyTick;
+static uint64_t keyCycles;
+static uint64_t frameCycles;
+static int idleCalls;
+
+static void setRtcTime(int hour, int min, int sec)
+{
+	hostRtcSetTime((hour << 16) | (min << 8) | sec, (2024 << 16) | (5 << 8) | 17);
+}
+
+/* Power mode writes traced since start, R07h display control and R10h power control only */
+static int powerWrites(struct HostLcdRegisterWrite* writes)
+{
+	int count = 0;
+	int traced = hostLcdTraced() < TRACE_LEN ? hostLcdTraced() : TRACE_LEN;
+	for(int n = 0; n < traced; n++)
+	{
+		if(trace[n].reg == 0x07 || trace[n].reg == 0x10)
+		{
+			writes[count++] = trace[n];
+		}
+	}
+	return count;
+}
+
+static bool isPowerSequence(const struct HostLcdRegisterWrite* expected, int length)
+{
+	struct HostLcdRegisterWrite writes[TRACE_LEN];
+	if(powerWrites(writes) != length)
+	{
+		return false;
+	}
+	for(int n = 0; n < length; n++)
+	{
+		if(writes[n].reg != expected[n].reg || writes[n].value != expected[n].value)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Every wait of the display task, as time runs without keys */
+static void displayIdle(void)
+{
+	uint32_t elapsed = osKernelGetTickCount() - startTick;
+	struct HostLcdCounters since = hostLcdSince(&standbyStart);
+	switch(idleCalls++)
+	{
+		case 0:  // after the full frame, full colors
+			CHECK(hostLcdRegister(0x07) == 0x0133);
+			break;
+		case 1:  // dimmed to 8 colors
+			CHECK(elapsed == DIM_TICKS);
+			CHECK(hostLcdRegister(0x07) == 0x013B);
+			CHECK((hostLcdRegister(0x10) & 0x0001) == 0);
+			break;
+		case 2:  // standby, the seconds interrupt is off and a stray one is ignored
+			CHECK(elapsed >= STANDBY_TICKS);
+			CHECK(isPowerSequence((const struct HostLcdRegisterWrite[]){
+				{0x07, 0x013B}, {0x07, 0x0131}, {0x07, 0x0130}, {0x07, 0x0000}, {0x10, 0x1091}}, 5));
+			CHECK(hostLcdRegister(0x10) & 0x0001);
+			CHECK(LPC_RTC->CIIR == 0);
+			CHECK(since.gramWrites == 0);  // power writes only
+			hostLcdCounters(&standbyStart);
+			setRtcTime(12, 34, 57);
+			RTC_IRQHandler();
+			break;
+		case 3:  // still in standby at the end of the run, then a key
+			CHECK(since.gramWrites == 0 && since.indexWrites == 0 && since.gpioAccesses == 0);
+			setRtcTime(12, 34, 56);  // the clock as retained, so the wake frame has nothing to draw
+			keyTick = osKernelGetTickCount();
+			keyCycles = hostDeviceCycles();
+			osEventFlagsSet(displayEvents, FIRMWARE_DISPLAY_FLAG_ACTIVITY);
+			break;
+		case 4:  // first frame after the key
+			frameCycles = hostDeviceCycles() - keyCycles;
+			CHECK(isPowerSequence((const struct HostLcdRegisterWrite[]){
+				{0x07, 0x013B}, {0x07, 0x0131}, {0x07, 0x0130}, {0x07, 0x0000}, {0x10, 0x1091},
+				{0x10, 0x1090}, {0x07, 0x0133}}, 7));
+			CHECK((hostLcdRegister(0x10) & 0x0001) == 0);
+			CHECK(LPC_RTC->CIIR == 0x01);
+			break;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	osKernelInitialize();
+	osKernelStart();  // power mode delays are osDelay, as in the display task
+	hostLcdReset();
+	lcdConfiguration();
+	init_ILI9325();
+	configure_lpc_rtc();
+	displayEventsSetup();
+	rtcSecondInterruptSetup();
+	setRtcTime(12, 34, 56);
+	hostRtosRun(logic_task, NULL);  // first snapshot
+
+	lcdCanvasInvalidate();
+	clearScreen();
+	invalidateScreen();
+	osEventFlagsSet(displayEvents, FIRMWARE_DISPLAY_FLAGS_ALL);
+	hostRtosRun(display_task, NULL);
+	memcpy(retained, hostGram, sizeof(retained));
+
+	hostLcdTraceRegisters(trace, TRACE_LEN);
+	hostLcdCounters(&standbyStart);
+	startTick = osKernelGetTickCount();
+	hostRtosIdle = displayIdle;
+	hostRtosRunFor(display_task, NULL, RUN_TICKS);
+	hostRtosIdle = NULL;
+
+	CHECK(idleCalls == 5);
+	CHECK(memcmp(retained, hostGram, sizeof(retained)) == 0);  // the key found the screen as it was left
+	printf("wake to first frame %u ms, %llu cycles of bus work\n",
+		osKernelGetTickCount() - keyTick, (unsigned long long)frameCycles);
+	CHECK(hostLcdSince(&(struct HostLcdCounters){0}).timingErrors == 0);
+	return hostTestResult();
+}
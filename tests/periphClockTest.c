@@ -0,0 +1,37 @@
+/* PCLKSEL is written once, before PLL0 connects: periphPowerClockSetup
+ * sets every divider, powering blocks on and off leaves them alone */
+
+#include "hostTest.h"
+#include "periphPower.h"
+
+#include <LPC17xx.h>
+#include <stdio.h>
+
+static uint32_t pclkField(uint32_t pclkBit)
+{
+	uint32_t pclksel = pclkBit < 32 ? LPC_SC->PCLKSEL0 : LPC_SC->PCLKSEL1;
+	return (pclksel >> (pclkBit % 32)) & 3U;
+}
+
+int main(int argc, char** argv)
+{
+	LPC_SC->PCLKSEL0 = 0xFFFFFFFF;
+	LPC_SC->PCLKSEL1 = 0xFFFFFFFF;
+	periphPowerClockSetup();
+	printf("PCLKSEL0 %08X PCLKSEL1 %08X\n", (unsigned)LPC_SC->PCLKSEL0, (unsigned)LPC_SC->PCLKSEL1);
+	CHECK(pclkField(34) == PERIPH_PCLK_DIV_8);  // GPIO interrupts
+	CHECK(pclkField(2) == PERIPH_PCLK_DIV_4);   // TIMER0
+	CHECK(pclkField(58) == PERIPH_PCLK_DIV_4);  // RIT
+	CHECK((LPC_SC->PCLKSEL0 & 0x000C0C00) == 0 && (LPC_SC->PCLKSEL1 & 0x03000300) == 0);  // reserved bits
+
+	uint32_t pclksel0 = LPC_SC->PCLKSEL0;
+	uint32_t pclksel1 = LPC_SC->PCLKSEL1;
+	periphPowerAcquire(PERIPH_POWER_GPIO);
+	periphPowerAcquire(PERIPH_POWER_TIMER0);
+	CHECK(periphPowerEnabled() & (1U << 15));
+	periphPowerRelease(PERIPH_POWER_TIMER0);
+	periphPowerRelease(PERIPH_POWER_GPIO);
+	CHECK((periphPowerEnabled() & ((1U << 15) | (1U << 1))) == 0);
+	CHECK(LPC_SC->PCLKSEL0 == pclksel0 && LPC_SC->PCLKSEL1 == pclksel1);
+	return hostTestResult();
+}
@@ -0,0 +1,51 @@
+/* Unlock and relock many times, the RTOS heap low watermark has
+ * to stay where startup left it, the logic task stack high water
+ * mark where the first unlock left it */
+
+#include "hostDevice.h"
+#include "hostKeypad.h"
+#include "hostTest.h"
+#include "firmware.h"
+#include "FreeRTOS.h"
+
+#include <stdio.h>
+
+#define UNLOCKS 1000
+#define LED_BIT (1U << 3)  // P0.3, low while unlocked
+
+static const uint8_t CODE_KEYS[] = {0, 1, 2, 4};  // 1 2 3 4, the default code
+
+int main(int argc, char** argv)
+{
+	firmwareMain();  // startup up to the kernel start, no thread runs yet
+	hostRtosRun(logic_task, NULL);
+	size_t startupMinimum = xPortGetMinimumEverFreeHeapSize();
+	CHECK(hostGpioOutput(0) & LED_BIT);
+
+	int unlocks = 0;
+	size_t firstUnlockStack = 0;
+	for(int cycle = 0; cycle < UNLOCKS; cycle++)
+	{
+		for(unsigned int digit = 0; digit < sizeof(CODE_KEYS); digit++)
+		{
+			hostKeypadPress(CODE_KEYS[digit]);
+		}
+		hostRtosRun(logic_task, NULL);
+		unlocks += (hostGpioOutput(0) & LED_BIT) == 0;
+		relockCallback(NULL);  // relock timer expired
+		hostRtosRun(logic_task, NULL);
+		CHECK(hostGpioOutput(0) & LED_BIT);
+		if(cycle == 0)
+		{
+			firstUnlockStack = hostRtosStackUsed();
+		}
+	}
+	printf("%d unlocks, heap free %zu, minimum ever %zu, after startup %zu\n", unlocks,
+		xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize(), startupMinimum);
+	printf("stack high water %zu bytes, after the first unlock %zu (host frames)\n",
+		hostRtosStackUsed(), firstUnlockStack);
+	CHECK(unlocks == UNLOCKS);
+	CHECK(xPortGetMinimumEverFreeHeapSize() == startupMinimum);
+	CHECK(firstUnlockStack > 0 && hostRtosStackUsed() == firstUnlockStack);
+	return hostTestResult();
+}
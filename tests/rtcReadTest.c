@@ -0,0 +1,47 @@
+/* The clock rolls over from 2024.12.31 23:59:59 between any two RTC
+ * register reads, readRtcDate gives one of the two dates, never a mix */
+
+#include "hostDevice.h"
+#include "hostTest.h"
+#include "firmware.h"
+
+#include <stdio.h>
+
+#define CTIME0(hour, min, sec) (((hour) << 16) | ((min) << 8) | (sec))
+#define CTIME1(year, month, day) (((year) << 16) | ((month) << 8) | (day))
+
+static int accesses;
+static int rollAt;
+
+static void rollOver(void)
+{
+	if(accesses++ == rollAt)
+	{
+		hostRtcSetTime(CTIME0(0, 0, 0), CTIME1(2025, 1, 1));
+	}
+}
+
+static bool isDate(const struct Date* date, int year, int month, int day, int hour, int min, int sec)
+{
+	return date->year == year && date->month == month && date->day == day
+		&& date->hour == hour && date->min == min && date->sec == sec;
+}
+
+int main(int argc, char** argv)
+{
+	hostRtcTick = rollOver;
+	for(rollAt = 0; rollAt < 6; rollAt++)
+	{
+		hostRtcSetTime(CTIME0(23, 59, 59), CTIME1(2024, 12, 31));
+		accesses = 0;
+		struct Date date;
+		readRtcDate(&date);
+		bool consistent = isDate(&date, 2024, 12, 31, 23, 59, 59) || isDate(&date, 2025, 1, 1, 0, 0, 0);
+		if(!CHECK(consistent))
+		{
+			fprintf(stderr, "roll before access %d: %04d.%02d.%02d %02d:%02d:%02d\n", rollAt,
+				date.year, date.month, date.day, date.hour, date.min, date.sec);
+		}
+	}
+	return hostTestResult();
+}
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Packed font generator.
+
+Reads 8x16 glyphs from asciiLib.c, keeps only the requested characters,
+optionally upscales them and writes a run-length encoded C table for
+packedFont.h.
+
+Each glyph is a run list in GRAM window order (rows top to bottom, left to
+right), runs alternate background and foreground starting with background.
+Runs are 4 bit, high nibble first, every glyph starts on a byte. A run of 15
+is continued by the next one without changing color, so a run of exactly 15
+pixels is written as 15, 0.
+
+  python3 tools/fontgen.py --chars 0-9 --scale 2 --name FONT_DIGITS_16X32 > fontDigits16x32.c
+"""
+
+import argparse
+import re
+import sys
+
+GLYPH_WIDTH = 8
+GLYPH_HEIGHT = 16
+FIRST_CHAR = 32
+FONTS = {"gothic": 0, "system": 1}
+
+
+def read_fonts(path):
+    with open(path, encoding="latin-1") as source:
+        text = source.read()
+    rows = re.findall(r"^\{((?:0x[0-9A-Fa-f]{2},?){16})\}", text, re.M)
+    glyphs = [[int(v, 16) for v in row.split(",") if v] for row in rows]
+    return [glyphs[n:n + 95] for n in range(0, len(glyphs), 95)]
+
+
+def to_pixels(rows):
+    return [[(row >> (GLYPH_WIDTH - 1 - col)) & 1 for col in range(GLYPH_WIDTH)] for row in rows]
+
+
+def scale2x(pixels):
+    """EPX, keeps diagonals smooth instead of doubling staircase steps"""
+    height, width = len(pixels), len(pixels[0])
+
+    def at(y, x):
+        return pixels[y][x] if 0 <= y < height and 0 <= x < width else 0
+
+    out = [[0] * (width * 2) for _ in range(height * 2)]
+    for y in range(height):
+        for x in range(width):
+            p, a, b, c, d = at(y, x), at(y - 1, x), at(y, x + 1), at(y, x - 1), at(y + 1, x)
+            e = [p, p, p, p]
+            if c == a and c != d and a != b:
+                e[0] = a
+            if a == b and a != c and b != d:
+                e[1] = b
+            if d == c and d != b and c != a:
+                e[2] = c
+            if b == d and b != a and d != c:
+                e[3] = d
+            out[2 * y][2 * x], out[2 * y][2 * x + 1] = e[0], e[1]
+            out[2 * y + 1][2 * x], out[2 * y + 1][2 * x + 1] = e[2], e[3]
+    return out
+
+
+def encode(pixels):
+    runs = []
+    color, length = 0, 0
+    for pixel in (p for row in pixels for p in row):
+        if pixel != color:
+            runs.append(length)
+            color, length = pixel, 0
+        length += 1
+    runs.append(length)
+    nibbles = []
+    for run in runs:
+        nibbles += [15] * (run // 15) + [run % 15]
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    return [(nibbles[n] << 4) | nibbles[n + 1] for n in range(0, len(nibbles), 2)]
+
+
+def parse_chars(spec):
+    first, _, last = spec.partition("-")
+    return ord(first), ord(last or first)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--source", default="asciiLib.c")
+    parser.add_argument("--font", choices=FONTS, default="gothic")
+    parser.add_argument("--chars", default="0-9", help="first-last character")
+    parser.add_argument("--scale", type=int, choices=(1, 2, 4), default=1)
+    parser.add_argument("--name", required=True)
+    args = parser.parse_args()
+
+    first, last = parse_chars(args.chars)
+    font = read_fonts(args.source)[FONTS[args.font]]
+    width, height = GLYPH_WIDTH * args.scale, GLYPH_HEIGHT * args.scale
+
+    offsets, data, lines = [], [], []
+    for code in range(first, last + 1):
+        pixels = to_pixels(font[code - FIRST_CHAR])
+        for _ in range(args.scale.bit_length() - 1):
+            pixels = scale2x(pixels)
+        runs = encode(pixels)
+        offsets.append(len(data))
+        data += runs
+        lines.append("\t%s,  // '%c'" % (",".join("0x%02X" % run for run in runs), code))
+
+    out = sys.stdout
+    out.write("/* Generated by tools/fontgen.py %s, do not edit */\n" % " ".join(sys.argv[1:]))
+    out.write("/* %d glyphs, %d bytes of runs, %d bytes as 1bpp bitmap */\n\n"
+              % (len(offsets), len(data), len(offsets) * width * height // 8))
+    out.write('#include "packedFont.h"\n\n')
+    out.write("static const uint8_t RUNS[] = {\n%s\n};\n\n" % "\n".join(lines))
+    out.write("static const uint16_t OFFSETS[] = {%s};\n\n" % ",".join(str(o) for o in offsets))
+    out.write("const struct PackedFont %s = {\n\t%d, %d, '%c', '%c', OFFSETS, RUNS\n};\n"
+              % (args.name, width, height, chr(first), chr(last)))
+
+
+if __name__ == "__main__":
+    main()